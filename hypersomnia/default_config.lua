@@ -51,6 +51,32 @@ return {
 	key_pem_path = ""
   },
 
+  load_test = {
+	connect_address = "127.0.0.1",
+	num_clients = 64,
+	duration_secs = 60,
+	connect_one_every_secs = 0.05,
+
+	random_inputs = true,
+	random_seed = 0,
+	change_inputs_once_every_secs = 0.5,
+
+	-- Every client loads the arena and predicts like a real one. The arena must be found locally.
+	simulate_prediction = true,
+
+	disabled_network_simulator = {
+	  latency_ms = 50,
+	  jitter_ms = 10,
+	  loss_percent = 1,
+	  duplicates_percent = 1
+	},
+
+	log_summary_once_every_secs = 5,
+	report_path = "",
+
+	sleep_ms = 1
+  },
+
   float_consistency_test = {
 	  passes = 5000
 	  , report_filename = ""
@@ -223,7 +249,10 @@ treat_as_music_sounds_longer_than_secs = 5,
     regenerate_every_time = false,
 	rescan_assets_on_window_focus = true,
 	atlas_blitting_threads = 3,
-	neon_regeneration_threads = 3
+	neon_regeneration_threads = 3,
+	cache_atlases = true,
+	max_cached_atlases = 8,
+	stream_sounds_longer_than_secs = 20
   },
   debug = {
     determinism_test_cloned_cosmoi_count = 0,
@@ -362,7 +391,9 @@ treat_as_music_sounds_longer_than_secs = 5,
 
   debugger = {
 	player = {
-		snapshot_interval_in_steps = 800
+		snapshot_interval_in_steps = 800,
+		snapshot_keyframe_interval = 8,
+		max_snapshots_memory_mb = 512
 	},
     grid = {
       render = {
@@ -659,7 +690,8 @@ treat_as_music_sounds_longer_than_secs = 5,
     break_on_failure = true,
     log_successful = false,
     redirect_log_to_path = "",
-    run = false
+    run = false,
+    run_benchmarks = false
   },
   window = {
     app_icon_path = "content/gfx/necessary/app.ico",
@@ -741,6 +773,17 @@ treat_as_music_sounds_longer_than_secs = 5,
 	slots = 10
   },
 
+  dedicated_server = {
+    -- Arenas hosted by the same dedicated server process in addition to the main one.
+    -- Each one listens at the next port after the main server's port,
+    -- is listed under the main server's name with a " #2", " #3"... suffix,
+    -- and writes its performance metrics next to the main server's file, suffixed with its port.
+    -- NAT detection is performed separately for every port.
+    -- All arenas are stepped one after another on a single thread,
+    -- so the sum of their step times has to fit within a single tick.
+    additional_arenas = {}
+  },
+
   server_private = {
     master_rcon_password = "",
     rcon_password = "",
@@ -756,8 +799,15 @@ treat_as_music_sounds_longer_than_secs = 5,
     report_ranked_match_api_key = "",
     report_ranked_match_url = "https://hypersomnia.xyz/report_match",
 
-    check_ban_endpoint = ""
+    check_ban_endpoint = "",
     --check_ban_endpoint = "https://hypersomnia.xyz/check_ban"
+
+    -- Dedicated servers only.
+    -- If set, periodically writes the step timings to this file in the Prometheus text format,
+    -- with p50/p99/p999 and max for the period since the last write, plus cumulative _sum and _count.
+    -- E.g. point it at the textfile collector directory of node_exporter.
+    performance_metrics_path = "",
+    write_performance_metrics_once_every_secs = 10
   },
 
   server = {
@@ -884,6 +934,7 @@ treat_as_music_sounds_longer_than_secs = 5,
     },
 
     max_buffered_client_commands = 1280,
+    max_jitter_buffer_ms = 150,
     state_hash_once_every_tick = 1,
     send_net_statistics_update_once_every_secs = 0.5,
 
@@ -891,6 +942,8 @@ treat_as_music_sounds_longer_than_secs = 5,
     auto_authorize_internal_for_rcon = false,
     max_unauthorized_rcon_commands = 100,
     max_bots = 0,
+    solver_worker_threads = 0,
+    max_reinferred_round_state_mb = 256,
     max_direct_file_bandwidth = 6
   },
 
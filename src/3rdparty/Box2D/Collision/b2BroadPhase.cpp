@@ -119,6 +119,21 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 }
 
 b2BroadPhase& b2BroadPhase::operator=(const b2BroadPhase& b) {
+	if (this == &b) {
+		return *this;
+	}
+
+	// The buffers are reused whenever their capacity already matches.
+	if (m_pairCapacity != b.m_pairCapacity) {
+		b2Free(m_pairBuffer);
+		m_pairBuffer = (b2Pair*)b2Alloc(b.m_pairCapacity * sizeof(b2Pair));
+	}
+
+	if (m_moveCapacity != b.m_moveCapacity) {
+		b2Free(m_moveBuffer);
+		m_moveBuffer = (int32*)b2Alloc(b.m_moveCapacity * sizeof(int32));
+	}
+
 	m_proxyCount = b.m_proxyCount;
 
 	m_moveCapacity = b.m_moveCapacity;
@@ -129,12 +144,6 @@ b2BroadPhase& b2BroadPhase::operator=(const b2BroadPhase& b) {
 
 	m_queryProxyId = b.m_queryProxyId;
 
-	b2Free(m_pairBuffer);
-	b2Free(m_moveBuffer);
-
-	m_pairBuffer = (b2Pair*)b2Alloc(m_pairCapacity * sizeof(b2Pair));
-	m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
-
 	memcpy(m_pairBuffer, b.m_pairBuffer, m_pairCount * sizeof(b2Pair));
 	memcpy(m_moveBuffer, b.m_moveBuffer, m_moveCount * sizeof(int32));
 
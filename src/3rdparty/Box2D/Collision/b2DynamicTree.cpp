@@ -795,7 +795,10 @@ void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 
 b2DynamicTree& b2DynamicTree::operator=(const b2DynamicTree& b) 
 {
-	this->~b2DynamicTree();
+	if (this == &b)
+	{
+		return *this;
+	}
 
 	const auto bytes = b.m_nodeCapacity * sizeof(b2TreeNode);
 #if DEBUG_PHYSICS_WORLD_CACHE_COPY
@@ -806,7 +809,13 @@ b2DynamicTree& b2DynamicTree::operator=(const b2DynamicTree& b)
 #endif
 #endif
 
-	m_nodes = (b2TreeNode*)b2Alloc(static_cast<int32>(bytes));
+	// Cloning the same world over and over keeps the capacity, so the node buffer is reused.
+	if (m_nodes == nullptr || m_nodeCapacity != b.m_nodeCapacity)
+	{
+		b2Free(m_nodes);
+		m_nodes = (b2TreeNode*)b2Alloc(static_cast<int32>(bytes));
+	}
+
 	memcpy(m_nodes, b.m_nodes, bytes);
 
 	m_root = b.m_root;
@@ -825,5 +834,6 @@ b2DynamicTree& b2DynamicTree::operator=(const b2DynamicTree& b)
 
 b2DynamicTree::b2DynamicTree(const b2DynamicTree& b) {
 	m_nodes = nullptr;
+	m_nodeCapacity = 0;
 	*this = b;
 }
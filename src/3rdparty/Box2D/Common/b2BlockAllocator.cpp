@@ -21,6 +21,7 @@
 #include <climits>
 #include <cstring>
 #include <memory>
+#include <algorithm>
 
 #include "augs/build_settings/setting_debug_physics_world_cache_copy.h"
 
@@ -229,3 +230,90 @@ void b2BlockAllocator::Clear()
 
 	memset(m_freeLists, 0, sizeof(m_freeLists));
 }
+
+void b2BlockAllocator::CloneFrom(const b2BlockAllocator& source)
+{
+	b2Assert(this != &source);
+
+	if (m_chunkSpace < source.m_chunkCount)
+	{
+		b2Chunk* oldChunks = m_chunks;
+		m_chunkSpace = source.m_chunkSpace;
+		m_chunks = (b2Chunk*)b2Alloc(m_chunkSpace * sizeof(b2Chunk));
+		memcpy(m_chunks, oldChunks, m_chunkCount * sizeof(b2Chunk));
+		memset(m_chunks + m_chunkCount, 0, (m_chunkSpace - m_chunkCount) * sizeof(b2Chunk));
+		b2Free(oldChunks);
+	}
+
+	for (int32 i = source.m_chunkCount; i < m_chunkCount; ++i)
+	{
+		b2Free(m_chunks[i].blocks);
+		m_chunks[i].blocks = NULL;
+	}
+
+	for (int32 i = m_chunkCount; i < source.m_chunkCount; ++i)
+	{
+		m_chunks[i].blocks = (b2Block*)b2Alloc(b2_chunkSize);
+	}
+
+	m_chunkCount = source.m_chunkCount;
+	m_rebaseTable.resize(m_chunkCount);
+
+	for (int32 i = 0; i < m_chunkCount; ++i)
+	{
+		const b2Chunk& from = source.m_chunks[i];
+		b2Chunk& to = m_chunks[i];
+
+		to.blockSize = from.blockSize;
+		memcpy(to.blocks, from.blocks, b2_chunkSize);
+
+		m_rebaseTable[i] = { (const int8*)from.blocks, (int8*)to.blocks };
+	}
+
+	std::sort(m_rebaseTable.begin(), m_rebaseTable.end(), [](const b2ChunkRebase& a, const b2ChunkRebase& b) {
+		return a.source < b.source;
+	});
+
+	// The free blocks link to each other through the copied memory.
+	for (int32 i = 0; i < b2_blockSizes; ++i)
+	{
+		m_freeLists[i] = Rebase(source.m_freeLists[i]);
+
+		for (b2Block* block = m_freeLists[i]; block; block = block->next)
+		{
+			block->next = Rebase(block->next);
+		}
+	}
+
+#if DEBUG_PHYSICS_WORLD_CACHE_COPY
+	m_numAllocatedObjects = source.m_numAllocatedObjects;
+#endif
+}
+
+void* b2BlockAllocator::Rebase(const void* p) const
+{
+	if (p == NULL)
+	{
+		return NULL;
+	}
+
+	const int8* bytes = (const int8*)p;
+
+	auto it = std::upper_bound(m_rebaseTable.begin(), m_rebaseTable.end(), bytes, [](const int8* b, const b2ChunkRebase& r) {
+		return b < r.source;
+	});
+
+	if (it == m_rebaseTable.begin())
+	{
+		return NULL;
+	}
+
+	--it;
+
+	if (bytes >= it->source + b2_chunkSize)
+	{
+		return NULL;
+	}
+
+	return it->target + (bytes - it->source);
+}
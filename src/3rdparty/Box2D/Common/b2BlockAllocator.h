@@ -19,6 +19,9 @@
 #ifndef B2_BLOCK_ALLOCATOR_H
 #define B2_BLOCK_ALLOCATOR_H
 
+#include <vector>
+#include <type_traits>
+
 #include <Box2D/Common/b2Settings.h>
 #include "augs/build_settings/setting_debug_physics_world_cache_copy.h"
 
@@ -47,10 +50,35 @@ public:
 
 	void Clear();
 
+	/// The number of chunks allocated so far, each b2_chunkSize bytes.
+	int32 GetChunkCount() const { return m_chunkCount; }
+
+	/// Make this allocator an exact copy of the source, one memcpy per chunk.
+	/// Chunks already owned by this allocator are reused.
+	/// Pointers stored inside the copied blocks still point into the source
+	/// and have to be translated with Rebase.
+	void CloneFrom(const b2BlockAllocator& source);
+
+	/// Translate a pointer into the chunks of the allocator last passed to CloneFrom
+	/// into the corresponding pointer into this allocator's chunks.
+	/// Returns NULL for NULL, and for memory that did not come from the chunks,
+	/// i.e. allocations larger than b2_maxBlockSize.
+	void* Rebase(const void* p) const;
+
+	template <class T>
+	std::remove_const_t<T>* Rebase(T* p) const {
+		return static_cast<std::remove_const_t<T>*>(Rebase(static_cast<const void*>(p)));
+	}
+
 	b2BlockAllocator& operator=(const b2BlockAllocator&) {
 		return *this;
 	}
 private:
+	struct b2ChunkRebase
+	{
+		const int8* source;
+		int8* target;
+	};
 
 	b2Chunk* m_chunks;
 	int32 m_chunkCount;
@@ -58,6 +86,9 @@ private:
 
 	b2Block* m_freeLists[b2_blockSizes];
 
+	/// Sorted by the source address, filled by CloneFrom.
+	std::vector<b2ChunkRebase> m_rebaseTable;
+
 #if DEBUG_PHYSICS_WORLD_CACHE_COPY
 public:
 	unsigned m_numAllocatedObjects;
@@ -91,6 +91,7 @@ extern augs::path_type USER_DIR;
 #define USER_DOWNLOADS_DIR 		(USER_DIR / "downloads")
 #define OFFICIAL_ARENAS_DIR  	(OFFICIAL_CONTENT_DIR / "arenas")
 #define DOWNLOADED_ARENAS_DIR 	(USER_DOWNLOADS_DIR / "arenas")
+#define DOWNLOADED_CONTENT_DIR 	(USER_DOWNLOADS_DIR / "content")
 #define DEMOS_DIR (USER_DIR / "demos")
 #define EDITOR_PROJECTS_DIR (USER_DIR / "projects")
 
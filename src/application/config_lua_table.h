@@ -50,6 +50,7 @@
 #include "application/performance_settings.h"
 #include "application/http_client/http_client_settings.h"
 #include "application/masterserver/masterserver_settings.h"
+#include "application/load_test/load_test_settings.h"
 #include "application/nat/nat_detection_settings.h"
 #include "application/nat/nat_traversal_settings.h"
 #include "fp_consistency_tests.h"
@@ -129,6 +130,7 @@ struct config_lua_table {
 	host_with_default_port extra_address_resolution_port;
 
 	masterserver_settings masterserver;
+	load_test_settings load_test;
 
 	std::vector<std::string> official_arena_servers;
 
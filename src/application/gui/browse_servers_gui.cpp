@@ -8,6 +8,7 @@
 #include "augs/readwrite/memory_stream.h"
 #include "augs/readwrite/pointer_to_buffer.h"
 #include "augs/readwrite/byte_readwrite.h"
+#include "augs/misc/compress.h"
 #include "application/setups/client/client_connect_string.h"
 #include "augs/log.h"
 #include "application/setups/debugger/detail/maybe_different_colors.h"
@@ -161,11 +162,30 @@ static std::vector<server_list_entry> to_server_list(std::optional<httplib::Resu
         return {};
     }
 
-    const auto& bytes = response->body;
+    const auto& body = response->body;
 
-    LOG("Server list response bytes: %x", bytes.size());
+    LOG("Server list response bytes: %x", body.size());
 
-    auto stream = augs::make_ptr_read_stream(bytes.data(), bytes.size());
+    std::vector<std::byte> decompressed;
+
+    if (response->get_header_value("Content-Encoding") == "lz4") {
+        try {
+            decompressed.resize(std::stoull(response->get_header_value("X-Uncompressed-Length")));
+            augs::decompress(reinterpret_cast<const std::byte*>(body.data()), body.size(), decompressed);
+        }
+        catch (const std::exception& err) {
+            error_message = "There was a problem decompressing the server list:\n" + std::string(err.what());
+            return {};
+        }
+
+        LOG("Decompressed server list bytes: %x", decompressed.size());
+    }
+
+    auto stream = 
+        decompressed.empty() ?
+        augs::make_ptr_read_stream(body.data(), body.size()) :
+        augs::make_ptr_read_stream(decompressed.data(), decompressed.size())
+    ;
 
 	std::vector<server_list_entry> new_server_list;
 
@@ -230,7 +250,7 @@ void browse_servers_gui_state::sync_download_server_entry(
 			cli.set_read_timeout(timeout);
 			cli.set_follow_location(true);
 
-			return cli.Get("/server_list_binary");
+			return cli.Get("/server_list_binary", httplib::Headers { { "Accept-Encoding", "lz4" } });
 		}
 	;
 
@@ -311,7 +331,7 @@ void browse_servers_gui_state::refresh_server_list(const browse_servers_input in
 			cli.set_read_timeout(timeout);
 			cli.set_follow_location(true);
 
-			return cli.Get("/server_list_binary");
+			return cli.Get("/server_list_binary", httplib::Headers { { "Accept-Encoding", "lz4" } });
 		}
 	);
 
@@ -61,7 +61,7 @@ struct multi_arena_synchronizer_internal {
 	https_file_downloader external;
 	std::optional<arena_downloading_session> current_session;
 
-	multi_arena_synchronizer_internal(const parsed_url& url) : external(url) {}
+	multi_arena_synchronizer_internal(const parsed_url& url) : external(url, max_parallel_https_downloads_v) {}
 
 	auto make_requester(std::string arena_name) {
 		return [&downloader = this->external, arena_name](const augs::secure_hash_type&, const augs::path_type& path) {
@@ -119,7 +119,8 @@ void multi_arena_synchronizer::init_next_session() {
 		data->current_session = arena_downloading_session(
 			current_input.name,
 			current_input.version,
-			data->make_requester(current_input.name)
+			data->make_requester(current_input.name),
+			max_parallel_https_downloads_v
 		);
 	}
 }
@@ -1499,7 +1499,9 @@ void settings_gui_state::perform(
 				if (auto node = scoped_tree_node("Player")) {
 					auto& scope_cfg = config.editor.player;
 
-					revertable_slider(SCOPE_CFG_NVP(snapshot_interval_in_steps), 400u, 5000u);
+					revertable_slider(SCOPE_CFG_NVP(snapshot_interval_in_steps), 100u, 5000u);
+					revertable_slider(SCOPE_CFG_NVP(snapshot_keyframe_interval), 1u, 32u);
+					revertable_slider(SCOPE_CFG_NVP(max_snapshots_memory_mb), 0u, 4096u);
 				}
 
 				if (auto node = scoped_tree_node("Debug")) {
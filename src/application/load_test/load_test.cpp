@@ -0,0 +1,889 @@
+#if PLATFORM_UNIX
+#include <csignal>
+#include <cstring>
+#endif
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "augs/log.h"
+#include "augs/misc/randomization.h"
+#include "augs/misc/time_histogram.h"
+#include "augs/misc/timing/timer.h"
+#include "augs/misc/serialization_buffers.h"
+#include "augs/filesystem/file.h"
+#include "augs/templates/logically_empty.h"
+#include "augs/network/netcode_utils.h"
+
+#include "application/load_test/load_test.h"
+#include "application/load_test/load_test_settings.h"
+
+#include "application/network/client_adapter.hpp"
+#include "application/network/net_message_translation.h"
+#include "application/network/net_message_readwrite.h"
+#include "application/network/net_serialize.h"
+#include "application/network/payload_easily_movable.h"
+#include "application/network/client_state_type.h"
+#include "application/network/requested_client_settings.h"
+#include "application/network/resolve_address_result.h"
+#include "application/network/network_common.h"
+#include "application/network/simulation_receiver.h"
+#include "application/network/special_client_request.h"
+
+#include "application/intercosm.h"
+#include "application/arena/choose_arena.h"
+#include "application/arena/synced_dynamic_vars.h"
+#include "application/setups/server/server_vars.h"
+#include "application/setups/server/synced_meta_update.h"
+#include "application/setups/server/rcon_level.h"
+#include "view/mode_gui/arena/arena_player_meta.h"
+#include "view/client_arena_type.h"
+
+#if PLATFORM_UNIX
+extern std::atomic<int> signal_status;
+#endif
+
+using initial_snapshot_payload = full_arena_snapshot_payload<false>;
+
+void snap_interpolated_to_logical(cosmos&);
+
+/* One line of the CSV report per simulated client. */
+
+struct load_test_report_row {
+	std::string nickname;
+	bool connected = false;
+	client_state_type state = client_state_type::NETCODE_NEGOTIATING_CONNECTION;
+
+	std::size_t steps_received = 0;
+	std::size_t commands_sent = 0;
+	std::size_t repredictions = 0;
+	std::size_t desyncs = 0;
+
+	double command_rtt_p50_ms = 0.0;
+	double command_rtt_p99_ms = 0.0;
+	double command_rtt_max_ms = 0.0;
+
+	double prediction_p99_ms = 0.0;
+	double prediction_max_ms = 0.0;
+
+	float net_rtt_ms = 0.f;
+	float loss_percent = 0.f;
+	float sent_kbps = 0.f;
+	float received_kbps = 0.f;
+
+	std::string disconnect_reason;
+
+	static std::string get_header() {
+		return "nickname,connected,state,steps_received,commands_sent,repredictions,desyncs,command_rtt_p50_ms,command_rtt_p99_ms,command_rtt_max_ms,prediction_p99_ms,prediction_max_ms,net_rtt_ms,loss_percent,sent_kbps,received_kbps,disconnect_reason\n";
+	}
+
+	std::string to_line() const {
+		return typesafe_sprintf(
+			"%x,%x,%x,%x,%x,%x,%x,%x,%x,%x,%x,%x,%x,%x,%x,%x,\"%x\"\n",
+			nickname,
+			connected,
+			state,
+			steps_received,
+			commands_sent,
+			repredictions,
+			desyncs,
+			command_rtt_p50_ms,
+			command_rtt_p99_ms,
+			command_rtt_max_ms,
+			prediction_p99_ms,
+			prediction_max_ms,
+			net_rtt_ms,
+			loss_percent,
+			sent_kbps,
+			received_kbps,
+			disconnect_reason
+		);
+	}
+};
+
+/*
+	The same pair of arenas that a real client keeps.
+	The referential arena follows the server step by step,
+	the predicted one runs ahead of it with the commands the server has not acknowledged yet.
+*/
+
+class simulated_arena {
+	intercosm scene;
+	cosmos_solvable_significant clean_round_state;
+
+	all_rulesets_variant ruleset;
+	all_modes_variant current_mode_state;
+	synced_dynamic_vars sv_dynamic_vars;
+	arena_player_metas player_metas;
+
+	cosmos predicted_cosmos;
+	all_modes_variant predicted_mode;
+
+	interpolation_system interp;
+	past_infection_system past;
+
+	template <class H, class S>
+	static decltype(auto) get_arena_handle_impl(S& self, const client_arena_type t) {
+		if (t == client_arena_type::PREDICTED) {
+			return H {
+				self.predicted_mode,
+				self.scene,
+				self.predicted_cosmos,
+				self.ruleset,
+				self.clean_round_state,
+				self.sv_dynamic_vars
+			};
+		}
+		else {
+			ensure_eq(t, client_arena_type::REFERENTIAL);
+
+			return H {
+				self.current_mode_state,
+				self.scene,
+				self.scene.world,
+				self.ruleset,
+				self.clean_round_state,
+				self.sv_dynamic_vars
+			};
+		}
+	}
+
+	auto get_arena_handle(const client_arena_type t) {
+		return get_arena_handle_impl<online_arena_handle<false>>(*this, t);
+	}
+
+	void advance_predicted(const server_step_entropy& entropy) {
+		const auto result = get_arena_handle(client_arena_type::PREDICTED).advance(
+			entropy,
+			solver_callbacks(),
+			solve_settings()
+		);
+
+		if (result.state_inconsistent) {
+			receiver.schedule_reprediction = true;
+		}
+	}
+
+public:
+	simulation_receiver receiver;
+	server_public_vars sv_public_vars;
+	mode_player_id client_player_id;
+
+	/* Returns an error if the arena is not found locally, as simulated clients can't download it. */
+	std::optional<std::string> load_arena(
+		sol::state& lua,
+		const packaged_official_content& official,
+		const server_public_vars& new_vars
+	) {
+		sv_public_vars = new_vars;
+
+		try {
+			const auto choice_result = ::choose_arena_client(
+				{
+					editor_project_readwrite::reading_settings(),
+					lua,
+					get_arena_handle(client_arena_type::REFERENTIAL),
+					official,
+					new_vars.arena,
+					new_vars.game_mode,
+					clean_round_state,
+					new_vars.playtesting_context,
+					nullptr,
+					nullptr
+				},
+
+				new_vars.required_arena_hash
+			);
+
+			if (!choice_result.arena_folder_path.has_value()) {
+				return typesafe_sprintf("Arena \"%x\" with the required hash was not found locally.", new_vars.arena);
+			}
+		}
+		catch (const std::exception& err) {
+			return typesafe_sprintf("Failed to load arena \"%x\": %x", new_vars.arena, err.what());
+		}
+
+		/* The predicted cosmos still runs in the old arena. */
+		receiver.schedule_reprediction = true;
+
+		return std::nullopt;
+	}
+
+	template <class F>
+	void read_initial_snapshot(F&& read_payload, augs::serialization_buffers& buffers) {
+		uint32_t read_client_id = 0;
+		auto rcon = rcon_level_type::DENIED;
+
+		cosmic::change_solvable_significant(
+			scene.world, 
+			[&](cosmos_solvable_significant& signi) {
+				read_payload(
+					buffers,
+
+					clean_round_state,
+
+					initial_snapshot_payload {
+						signi,
+						current_mode_state,
+						read_client_id,
+						rcon
+					}
+				);
+
+				return changer_callback_result::REFRESH;
+			}
+		);
+
+		client_player_id = static_cast<mode_player_id>(read_client_id);
+
+		get_arena_handle(client_arena_type::PREDICTED).transfer_all_solvables(get_arena_handle(client_arena_type::REFERENTIAL));
+		snap_interpolated_to_logical(predicted_cosmos);
+
+		/* After a resync, the commands still in flight have to be predicted again on top of the new state. */
+		receiver.schedule_reprediction = true;
+		receiver.clear_incoming();
+	}
+
+	void on_dynamic_vars(const synced_dynamic_vars& new_vars) {
+		sv_dynamic_vars = new_vars;
+		receiver.schedule_reprediction = true;
+	}
+
+	void on_meta_update(const synced_meta_update& update) {
+		player_metas[update.subject_id.value].synced = update.new_meta;
+		receiver.schedule_reprediction = true;
+	}
+
+	entity_id get_controlled_character_id() {
+		return get_arena_handle(client_arena_type::PREDICTED).on_mode(
+			[&](const auto& typed_mode) {
+				return typed_mode.lookup(client_player_id);
+			}
+		);
+	}
+
+	steps_unpacking_result unpack_server_steps() {
+		auto referential_arena = get_arena_handle(client_arena_type::REFERENTIAL);
+		auto predicted_arena = get_arena_handle(client_arena_type::PREDICTED);
+
+		auto advance_referential = [&](const auto& entropy) {
+			referential_arena.advance(entropy, solver_callbacks(), solve_settings());
+
+			const auto& removed = entropy.general.removed_player;
+
+			if (logically_set(removed)) {
+				player_metas[removed.value].clear();
+			}
+		};
+
+		auto advance_repredicted = [&](const auto& entropy) {
+			advance_predicted(entropy);
+		};
+
+		auto unpack = [&](const compact_server_step_entropy& entropy) {
+			auto mode_id_to_entity_id = [&](const mode_player_id& mode_id) {
+				return referential_arena.on_mode(
+					[&](const auto& typed_mode) {
+						return typed_mode.lookup(mode_id);
+					}
+				);
+			};
+
+			auto get_settings_for = [&](const mode_player_id& mode_id) {
+				return player_metas[mode_id.value].synced.public_settings.character_input;
+			};
+
+			return entropy.unpack(mode_id_to_entity_id, get_settings_for);
+		};
+
+		return receiver.unpack_deterministic_steps(
+			simulation_receiver_settings(),
+			interp,
+			past,
+
+			get_controlled_character_id(),
+
+			unpack,
+
+			referential_arena,
+			predicted_arena,
+
+			advance_referential,
+			advance_repredicted
+		);
+	}
+
+	void predict(const total_client_entropy& sent, const per_character_input_settings& character_input) {
+		/* Assembled the way entropy_accumulator does it for a real client. */
+
+		server_step_entropy entropy;
+
+		if (logically_set(sent.mode)) {
+			entropy.players[client_player_id] = sent.mode;
+		}
+		else if (const auto character = get_controlled_character_id(); character.is_set()) {
+			auto& player_entry = entropy.cosmic[character];
+
+			player_entry.settings = character_input;
+			player_entry.commands = sent.cosmic;
+		}
+
+		receiver.predicted_entropies.push_back(entropy);
+		advance_predicted(entropy);
+	}
+};
+
+/*
+	With simulate_prediction disabled, simulated clients skip prediction altogether.
+	Of the reasons a real client repredicts, only those that come from the network can then be told apart:
+	a server step that did not accept exactly one command, a reinference, or the client falling behind the server.
+	Mispredicted inputs of other players are not counted, so the reprediction count is a lower bound.
+*/
+
+class simulated_client {
+	const load_test_settings& settings;
+
+	sol::state& lua;
+	const packaged_official_content& official;
+
+	std::string nickname;
+	client_adapter adapter;
+	randomization rng;
+
+	requested_client_settings welcome;
+
+	std::unique_ptr<simulated_arena> arena;
+	augs::serialization_buffers buffers;
+	bool now_resyncing = false;
+
+	client_state_type state = client_state_type::NETCODE_NEGOTIATING_CONNECTION;
+	std::string disconnect_reason;
+
+	bool chose_team = false;
+	std::optional<game_intent_type> held_movement;
+	bool held_shoot = false;
+	double when_changed_inputs = -1.0;
+
+	std::deque<double> unacknowledged_commands;
+	double current_time = 0.0;
+
+	double prediction_secs_this_frame = 0.0;
+
+	void send_command() {
+		total_client_entropy entropy;
+
+		if (!chose_team) {
+			entropy.mode = mode_commands::team_choice { faction_type::DEFAULT };
+			chose_team = true;
+		}
+		else if (settings.random_inputs) {
+			auto& commands = entropy.cosmic;
+
+			if (try_fire_interval(settings.change_inputs_once_every_secs, when_changed_inputs, current_time)) {
+				auto release = [&](const game_intent_type t) {
+					game_intent intent;
+					intent.intent = t;
+					intent.change = intent_change::RELEASED;
+					commands.intents.push_back(intent);
+				};
+
+				auto press = [&](const game_intent_type t) {
+					game_intent intent;
+					intent.intent = t;
+					intent.change = intent_change::PRESSED;
+					commands.intents.push_back(intent);
+				};
+
+				if (held_movement.has_value()) {
+					release(*held_movement);
+				}
+
+				const auto first_movement = static_cast<int>(game_intent_type::MOVE_FORWARD);
+				const auto last_movement = static_cast<int>(game_intent_type::MOVE_RIGHT);
+
+				held_movement = static_cast<game_intent_type>(rng.randval(first_movement, last_movement));
+				press(*held_movement);
+
+				const bool shoot = rng.randval(0, 3) == 0;
+
+				if (shoot != held_shoot) {
+					shoot ? press(game_intent_type::SHOOT) : release(game_intent_type::SHOOT);
+					held_shoot = shoot;
+				}
+			}
+
+			using offset_type = raw_game_motion_offset_type;
+			using coord_type = decltype(offset_type::x);
+
+			commands.motions[game_motion_type::MOVE_CROSSHAIR] = offset_type(
+				static_cast<coord_type>(rng.randval(-20, 20)),
+				static_cast<coord_type>(rng.randval(-20, 20))
+			);
+		}
+
+		if (adapter.send_payload(game_channel_type::RELIABLE_MESSAGES, entropy)) {
+			++commands_sent;
+			unacknowledged_commands.push_back(current_time);
+
+			if (arena != nullptr) {
+				augs::timer predicting;
+				arena->predict(entropy, welcome.public_settings.character_input);
+				prediction_secs_this_frame += predicting.get<std::chrono::seconds>();
+			}
+		}
+	}
+
+	void unpack_server_steps() {
+		augs::timer unpacking;
+
+		const auto result = arena->unpack_server_steps();
+
+		prediction_secs_this_frame += unpacking.get<std::chrono::seconds>();
+
+		if (result.should_repredict) {
+			++repredictions;
+		}
+
+		if (result.malicious_server) {
+			set_disconnect_reason("There was a problem unpacking steps from the server.");
+			disconnect();
+		}
+
+		if (result.desync) {
+			++desyncs;
+
+			if (!now_resyncing) {
+				adapter.send_payload(game_channel_type::RELIABLE_MESSAGES, special_client_request::RESYNC_ARENA);
+				now_resyncing = true;
+			}
+		}
+	}
+
+	void handle_server_step(const networked_server_step_entropy& step) {
+		++steps_received;
+
+		const auto num_accepted = static_cast<std::size_t>(step.context.num_entropies_accepted);
+
+		if (arena != nullptr) {
+			arena->receiver.acquire_next_server_entropy(
+				step.context,
+				step.meta, 
+				step.payload
+			);
+		}
+		else {
+			const bool would_reinfer =
+				step.meta.reinference_necessary
+				|| logically_set(step.payload.general.added_player)
+			;
+
+			const bool fell_behind = num_accepted > unacknowledged_commands.size();
+
+			if (num_accepted != 1 || would_reinfer || fell_behind) {
+				++repredictions;
+			}
+		}
+
+		for (std::size_t i = 0; i < num_accepted && !unacknowledged_commands.empty(); ++i) {
+			command_round_trip.record(current_time - unacknowledged_commands.front());
+			unacknowledged_commands.pop_front();
+		}
+
+		/* A real client advances at the server's tickrate, so one command per server step keeps the pace. */
+		send_command();
+	}
+
+public:
+	std::size_t steps_received = 0;
+	std::size_t commands_sent = 0;
+	std::size_t repredictions = 0;
+	std::size_t desyncs = 0;
+
+	augs::time_histogram command_round_trip;
+
+	/* Time spent per frame unpacking server steps, repredicting and predicting the sent commands. */
+	augs::time_histogram prediction_time;
+
+	simulated_client(
+		sol::state& lua,
+		const packaged_official_content& official,
+		const load_test_settings& settings,
+		const unsigned index
+	) :
+		settings(settings),
+		lua(lua),
+		official(official),
+		nickname(typesafe_sprintf("loadbot%x", index)),
+		adapter(std::nullopt, [](std::byte*, std::size_t) { return false; }),
+		rng(settings.random_seed + index)
+	{
+		welcome.chosen_nickname = nickname;
+		welcome.suppress_webhooks = true;
+
+		if (settings.simulate_prediction) {
+			arena = std::make_unique<simulated_arena>();
+		}
+
+		adapter.set(settings.network_simulator);
+
+		const auto resolution = adapter.connect(settings.connect_address);
+
+		if (resolution.result != resolve_result_type::OK) {
+			set_disconnect_reason(resolution.report());
+		}
+	}
+
+	void advance(const double now) {
+		current_time = now;
+
+		adapter.advance(now, *this);
+
+		if (arena != nullptr && is_in_game()) {
+			const auto& receiver = arena->receiver;
+
+			if (!receiver.incoming_entropies.empty() || receiver.schedule_reprediction) {
+				unpack_server_steps();
+			}
+
+			if (prediction_secs_this_frame > 0.0) {
+				prediction_time.record(prediction_secs_this_frame);
+				prediction_secs_this_frame = 0.0;
+			}
+		}
+
+		if (adapter.is_connected() && state == client_state_type::NETCODE_NEGOTIATING_CONNECTION) {
+			adapter.send_payload(game_channel_type::RELIABLE_MESSAGES, std::as_const(welcome));
+			state = client_state_type::PENDING_WELCOME;
+		}
+
+		if (adapter.is_connected()) {
+			adapter.send_packets();
+		}
+	}
+
+	template <class T, class F>
+	message_handler_result handle_payload(F&& read_payload) {
+		constexpr auto abort_v = message_handler_result::ABORT_AND_DISCONNECT;
+		constexpr auto continue_v = message_handler_result::CONTINUE;
+
+		if constexpr(!payload_easily_movable_v<T>) {
+			if constexpr(std::is_same_v<T, initial_snapshot_payload>) {
+				if (!now_resyncing && state < client_state_type::RECEIVING_INITIAL_SNAPSHOT) {
+					set_disconnect_reason(typesafe_sprintf("The server has sent initial state early (state: %x).", state));
+					return abort_v;
+				}
+
+				/* Without prediction the snapshot is never read: it is enough to know it has arrived. */
+
+				if (arena != nullptr) {
+					arena->read_initial_snapshot(read_payload, buffers);
+				}
+
+				now_resyncing = false;
+				state = client_state_type::IN_GAME;
+			}
+
+			return continue_v;
+		}
+		else {
+			T payload;
+
+			if (!read_payload(payload)) {
+				return abort_v;
+			}
+
+			if constexpr(std::is_same_v<T, server_public_vars>) {
+				const bool are_initial_vars = state == client_state_type::PENDING_WELCOME;
+
+				if (are_initial_vars) {
+					state = client_state_type::RECEIVING_INITIAL_SNAPSHOT;
+				}
+
+				if (arena != nullptr) {
+					const auto& old_vars = arena->sv_public_vars;
+
+					const bool reload_arena = 
+						payload.arena != old_vars.arena
+						|| payload.game_mode != old_vars.game_mode
+						|| payload.required_arena_hash != old_vars.required_arena_hash
+					;
+
+					if (are_initial_vars || reload_arena) {
+						if (const auto error = arena->load_arena(lua, official, payload)) {
+							set_disconnect_reason(*error);
+							return abort_v;
+						}
+					}
+				}
+			}
+			else if constexpr(std::is_same_v<T, synced_dynamic_vars>) {
+				if (arena != nullptr) {
+					arena->on_dynamic_vars(payload);
+				}
+			}
+			else if constexpr(std::is_same_v<T, synced_meta_update>) {
+				if (arena != nullptr) {
+					arena->on_meta_update(payload);
+				}
+			}
+			else if constexpr(std::is_same_v<T, networked_server_step_entropy>) {
+				if (state != client_state_type::IN_GAME) {
+					set_disconnect_reason(typesafe_sprintf("The server has sent entropy too early (state: %x).", state));
+					return abort_v;
+				}
+
+				handle_server_step(payload);
+			}
+
+			return continue_v;
+		}
+	}
+
+	template <class T>
+	void demo_record_server_message(T&) {}
+
+	void set_disconnect_reason(const std::string& reason) {
+		LOG("%x: %x", nickname, reason);
+		disconnect_reason = reason;
+	}
+
+	void disconnect() {
+		adapter.disconnect();
+	}
+
+	bool is_connected() const {
+		return adapter.is_connected();
+	}
+
+	bool is_in_game() const {
+		return is_connected() && state == client_state_type::IN_GAME;
+	}
+
+	network_info get_network_info() const {
+		return adapter.get_network_info();
+	}
+
+	load_test_report_row make_report_row() const {
+		const auto info = get_network_info();
+
+		load_test_report_row row;
+
+		row.nickname = nickname;
+		row.connected = is_connected();
+		row.state = state;
+
+		row.steps_received = steps_received;
+		row.commands_sent = commands_sent;
+		row.repredictions = repredictions;
+		row.desyncs = desyncs;
+
+		row.command_rtt_p50_ms = command_round_trip.percentile_secs(0.5) * 1000;
+		row.command_rtt_p99_ms = command_round_trip.percentile_secs(0.99) * 1000;
+		row.command_rtt_max_ms = command_round_trip.get_max_secs() * 1000;
+
+		row.prediction_p99_ms = prediction_time.percentile_secs(0.99) * 1000;
+		row.prediction_max_ms = prediction_time.get_max_secs() * 1000;
+
+		row.net_rtt_ms = info.rtt_ms;
+		row.loss_percent = info.loss_percent;
+		row.sent_kbps = info.sent_kbps;
+		row.received_kbps = info.received_kbps;
+
+		row.disconnect_reason = disconnect_reason;
+
+		return row;
+	}
+};
+
+static void log_summary(const std::vector<std::unique_ptr<simulated_client>>& clients) {
+	std::size_t num_connected = 0;
+	std::size_t num_in_game = 0;
+	std::size_t total_repredictions = 0;
+	std::size_t total_steps = 0;
+
+	float total_sent_kbps = 0.f;
+	float total_received_kbps = 0.f;
+	float total_rtt_ms = 0.f;
+
+	augs::time_histogram command_round_trip;
+	augs::time_histogram prediction_time;
+
+	for (const auto& c : clients) {
+		if (!c->is_connected()) {
+			continue;
+		}
+
+		++num_connected;
+
+		if (c->is_in_game()) {
+			++num_in_game;
+		}
+
+		const auto info = c->get_network_info();
+
+		total_sent_kbps += info.sent_kbps;
+		total_received_kbps += info.received_kbps;
+		total_rtt_ms += info.rtt_ms;
+
+		total_repredictions += c->repredictions;
+		total_steps += c->steps_received;
+
+		command_round_trip += c->command_round_trip;
+		prediction_time += c->prediction_time;
+	}
+
+	const auto avg_rtt_ms = num_connected > 0 ? total_rtt_ms / num_connected : 0.f;
+
+	LOG(
+		"Clients: %x/%x connected, %x in game. Avg RTT: %x ms. Command round trip p50/p99/max: %x/%x/%x ms. Prediction p50/p99/max: %x/%x/%x ms. Repredictions: %x/%x steps. Total sent: %x kbps, received: %x kbps.",
+		num_connected,
+		clients.size(),
+		num_in_game,
+		avg_rtt_ms,
+		command_round_trip.percentile_secs(0.5) * 1000,
+		command_round_trip.percentile_secs(0.99) * 1000,
+		command_round_trip.get_max_secs() * 1000,
+		prediction_time.percentile_secs(0.5) * 1000,
+		prediction_time.percentile_secs(0.99) * 1000,
+		prediction_time.get_max_secs() * 1000,
+		total_repredictions,
+		total_steps,
+		total_sent_kbps,
+		total_received_kbps
+	);
+}
+
+static void write_report(const augs::path_type& path, const std::vector<std::unique_ptr<simulated_client>>& clients) {
+	auto report = load_test_report_row::get_header();
+
+	for (const auto& c : clients) {
+		report += c->make_report_row().to_line();
+	}
+
+	try {
+		augs::save_as_text(path, report);
+		LOG("Wrote the load test report to %x", path);
+	}
+	catch (const std::exception& err) {
+		LOG("Failed to write the load test report to %x: %x", path, err.what());
+	}
+}
+
+void perform_load_test(
+	sol::state& lua,
+	const packaged_official_content& official,
+	const load_test_settings& settings
+) {
+	LOG(
+		"Starting a load test: %x clients connecting to %x for %x seconds.",
+		settings.num_clients,
+		settings.connect_address,
+		settings.duration_secs
+	);
+
+	std::vector<std::unique_ptr<simulated_client>> clients;
+	clients.reserve(settings.num_clients);
+
+	const auto started_at = yojimbo_time();
+	auto when_last_summary = started_at;
+
+	while (true) {
+#if PLATFORM_UNIX
+		if (signal_status != 0) {
+			const auto sig = signal_status.load();
+
+			LOG("%x received.", strsignal(sig));
+
+			if(
+				sig == SIGINT
+				|| sig == SIGSTOP
+				|| sig == SIGTERM
+			) {
+				LOG("Gracefully shutting down.");
+				break;
+			}
+		}
+#endif
+
+		const auto now = yojimbo_time();
+		const auto elapsed = now - started_at;
+
+		if (settings.duration_secs > 0.f && elapsed >= settings.duration_secs) {
+			break;
+		}
+
+		/* Connecting everyone at once would only measure the handshake. */
+		while (
+			clients.size() < settings.num_clients
+			&& elapsed >= clients.size() * settings.connect_one_every_secs
+		) {
+			clients.emplace_back(std::make_unique<simulated_client>(lua, official, settings, static_cast<unsigned>(clients.size())));
+		}
+
+		for (auto& c : clients) {
+			c->advance(now);
+		}
+
+		if (try_fire_interval(settings.log_summary_once_every_secs, when_last_summary, now)) {
+			log_summary(clients);
+		}
+
+		yojimbo_sleep(settings.sleep_ms / 1000);
+	}
+
+	log_summary(clients);
+
+	if (!settings.report_path.empty()) {
+		write_report(settings.report_path, clients);
+	}
+
+	for (auto& c : clients) {
+		c->disconnect();
+	}
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+static std::vector<std::string> split_csv_line(const std::string& line) {
+	std::vector<std::string> columns(1);
+	bool quoted = false;
+
+	for (const auto c : line) {
+		if (c == '"') {
+			quoted = !quoted;
+		}
+		else if (c == ',' && !quoted) {
+			columns.emplace_back();
+		}
+		else if (c != '\n') {
+			columns.back() += c;
+		}
+	}
+
+	return columns;
+}
+
+TEST_CASE("LoadTest ReportLineMatchesHeader") {
+	load_test_report_row row;
+
+	row.nickname = "loadbot7";
+	row.received_kbps = 42.f;
+	row.disconnect_reason = "Timed out, reconnecting";
+
+	const auto header = split_csv_line(load_test_report_row::get_header());
+	const auto line = split_csv_line(row.to_line());
+
+	REQUIRE(header.size() == 17);
+	REQUIRE(line.size() == header.size());
+
+	REQUIRE(header.front() == "nickname");
+	REQUIRE(line.front() == row.nickname);
+
+	REQUIRE(header[header.size() - 2] == "received_kbps");
+	REQUIRE(line[line.size() - 2] == "42");
+
+	REQUIRE(header.back() == "disconnect_reason");
+	REQUIRE(line.back() == row.disconnect_reason);
+}
+#endif
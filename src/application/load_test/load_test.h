@@ -0,0 +1,23 @@
+#pragma once
+
+namespace sol {
+	class state;
+}
+
+struct load_test_settings;
+struct packaged_official_content;
+
+/*
+	Connects many headless clients to a running server from a single process.
+
+	The clients go through the handshake, answer every server step with a command
+	and measure what the server makes them experience.
+	With simulate_prediction, they also load the arena and keep a referential and a predicted cosmos
+	through a simulation_receiver, so the cost of prediction and reprediction is measured as well.
+*/
+
+void perform_load_test(
+	sol::state&,
+	const packaged_official_content&,
+	const load_test_settings&
+);
@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include "augs/network/network_simulator_settings.h"
+#include "application/setups/client/client_connect_string.h"
+
+struct load_test_settings {
+	// GEN INTROSPECTOR struct load_test_settings
+	client_connect_string connect_address = "127.0.0.1";
+	unsigned num_clients = 64;
+	float duration_secs = 60.f;
+	float connect_one_every_secs = 0.05f;
+
+	bool random_inputs = true;
+	unsigned random_seed = 0;
+	float change_inputs_once_every_secs = 0.5f;
+
+	bool simulate_prediction = true;
+
+	augs::maybe_network_simulator network_simulator;
+
+	float log_summary_once_every_secs = 5.f;
+	std::string report_path = "";
+
+	float sleep_ms = 1;
+	// END GEN INTROSPECTOR
+};
@@ -23,9 +23,8 @@
 #include "augs/string/parse_url.h"
 #include "application/detail_file_paths.h"
 #include "application/setups/server/webhooks.h"
-#include "application/masterserver/server_list_entry_json.h"
-#include "3rdparty/rapidjson/include/rapidjson/prettywriter.h"
-#include "augs/readwrite/json_readwrite.h"
+#include "application/masterserver/masterserver_client.h"
+#include "application/masterserver/server_list_snapshot.h"
 #include "augs/network/netcode_utils.h"
 
 std::string to_lowercase(std::string s);
@@ -52,21 +51,6 @@ void MSR_LOG(Args&&... args) {
 #define MSR_LOG_NVPS MSR_LOG
 #endif
 
-struct masterserver_client_meta {
-	double time_hosted;
-
-	masterserver_client_meta() {
-		time_hosted = augs::date_time::secs_since_epoch();
-	}
-};
-
-struct masterserver_client {
-	double time_last_heartbeat;
-
-	masterserver_client_meta meta;
-	server_heartbeat last_heartbeat;
-};
-
 bool operator==(const netcode_address_t& a, const netcode_address_t& b) {
 	auto aa = a;
 	auto bb = b;
@@ -177,88 +161,45 @@ void perform_masterserver(const config_lua_table& cfg) try {
 
 	std::unordered_map<netcode_address_t, masterserver_client> server_list;
 
-	std::vector<std::byte> serialized_list;
-	std::string serialized_list_json = "[]";
+	server_list_serializer list_serializer;
+	server_list_snapshot_ptr published_list = std::make_shared<const server_list_snapshot>();
 
-	std::shared_mutex serialized_list_mutex;
+	std::shared_mutex published_list_mutex;
 
 	httplib::Server http;
 
 	const auto masterserver_dump_path = USER_DIR / "masterserver.dump";
 
-	auto reserialize_list = [&]() {
-		MSR_LOG("Reserializing the server list.");
-
-		std::lock_guard<std::shared_mutex> lock(serialized_list_mutex);
-
-		serialized_list.clear();
-
-		auto ss = augs::ref_memory_stream(serialized_list);
-
-		for (auto& server : server_list) {
-			const auto address = server.first;
+	auto reserialize_entry = [&](const netcode_address_t& address, const masterserver_client& entry) {
+		list_serializer.update(address, entry);
+	};
 
-			augs::write_bytes(ss, address);
-			augs::write_bytes(ss, server.second.meta.time_hosted);
-			augs::write_bytes(ss, server.second.last_heartbeat);
+	auto publish_list_if_changed = [&]() {
+		if (!list_serializer.is_dirty()) {
+			return;
 		}
 
-		rapidjson::StringBuffer s;
-		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(s);
-
-		writer.StartArray();
-
-		for (auto& server : server_list) {
-			const auto& data = server.second.last_heartbeat;
-
-			server_list_entry_json next;
+		auto new_list = list_serializer.make_snapshot();
 
-			next.server_version = data.server_version;
+		MSR_LOG("Publishing the server list (version %x, %x servers, %x bytes).", new_list->version, list_serializer.size(), new_list->binary.size());
 
-			next.name = data.server_name;
-			next.ip = ::ToString(server.first);
-
-			next.time_hosted = server.second.meta.time_hosted;
-			next.time_last_heartbeat = server.second.time_last_heartbeat;
-			next.arena = data.current_arena;
-			next.game_mode = data.game_mode;
-
-			next.num_spectating = data.get_num_spectators();
-			next.num_playing = data.num_online - next.num_spectating;
-
-			next.slots = data.max_online;
-
-			next.nat = data.nat.type;
-
-			if (data.internal_network_address.has_value()) {
-				next.internal_network_address = ::ToString(*data.internal_network_address);
-			}
-
-			if (data.is_editor_playtesting_server) {
-				next.is_editor_playtesting_server = data.is_editor_playtesting_server;
-			}
-
-			next.score_resistance = data.score_resistance;
-			next.score_metropolis = data.score_metropolis;
-
-			next.players_resistance = data.players_resistance;
-			next.players_metropolis = data.players_metropolis;
-			next.players_spectating = data.players_spectating;
-
-			augs::write_json(writer, next);
-		}
-
-		writer.EndArray();
+		std::lock_guard<std::shared_mutex> lock(published_list_mutex);
+		published_list = std::move(new_list);
+	};
 
-		serialized_list_json = s.GetString();
+	auto get_published_list = [&]() {
+		std::shared_lock<std::shared_mutex> lock(published_list_mutex);
+		return published_list;
 	};
 
 	auto dump_server_list_to_file = [&]() {
 		const auto n = server_list.size();
 
 		if (n > 0) {
+			publish_list_if_changed();
+
 			LOG("Saving %x servers to %x", n, masterserver_dump_path);
-			augs::bytes_to_file(std::as_const(serialized_list), masterserver_dump_path);
+			augs::bytes_to_file(get_published_list()->binary, masterserver_dump_path);
 		}
 		else {
 			LOG("The server list is empty: deleting the dump file.");
@@ -283,68 +224,109 @@ void perform_masterserver(const config_lua_table& cfg) try {
 
 				entry.time_last_heartbeat = current_time;
 
-				server_list.try_emplace(address, std::move(entry));
+				if (server_list.try_emplace(address, entry).second) {
+					reserialize_entry(address, entry);
+				}
 			}
 
-			reserialize_list();
+			publish_list_if_changed();
 		}
 		catch (const augs::file_open_error& err) {
 			LOG("Could not load the server list file: %x.\nStarting from an empty server list. Details:\n%x", masterserver_dump_path, err.what());
 
 			server_list.clear();
+			list_serializer.clear();
 		}
 		catch (const augs::stream_read_error& err) {
 			LOG("Failed to read the server list from file: %x.\nStarting from an empty server list. Details:\n%x", masterserver_dump_path, err.what());
 
 			server_list.clear();
+			list_serializer.clear();
 		}
 	};
 
 	load_server_list_from_file();
+	publish_list_if_changed();
 
-	auto make_list_streamer_lambda = [&]() {
-		return [data=serialized_list](uint64_t offset, uint64_t length, DataSink& sink) {
-			return sink.write(reinterpret_cast<const char*>(&data[offset]), length);
-		};
+	auto remove_from_list = [&](const auto& by_external_addr) {
+		server_list.erase(by_external_addr);
+		list_serializer.erase(by_external_addr);
 	};
 
-	auto make_json_list_streamer_lambda = [&]() {
-		return [data=serialized_list_json](uint64_t offset, uint64_t length, DataSink& sink) {
-			return sink.write(reinterpret_cast<const char*>(&data[offset]), length);
-		};
+	/* The snapshot is captured by value, so it outlives any newer list published mid-transfer. */
+	auto send_body = [](Response& res, server_list_snapshot_ptr list, const auto& body, const char* content_type) {
+		const auto* const data = reinterpret_cast<const char*>(body.data());
+
+		res.set_content_provider(
+			body.size(),
+			content_type,
+			[list=std::move(list), data](uint64_t offset, uint64_t length, DataSink& sink) {
+				return sink.write(data + offset, length);
+			}
+		);
 	};
 
-	auto remove_from_list = [&](const auto& by_external_addr) {
-		server_list.erase(by_external_addr);
-		reserialize_list();
+	auto not_modified = [](const Request& req, Response& res, const std::string& etag) {
+		if (etag.empty()) {
+			return false;
+		}
+
+		res.set_header("ETag", etag);
+
+		if (req.get_header_value("If-None-Match") == etag) {
+			res.status = 304;
+			return true;
+		}
+
+		return false;
 	};
 
 	auto define_http_server = [&]() {
-		http.Get("/server_list_binary", [&](const Request&, Response& res) {
-			std::shared_lock<std::shared_mutex> lock(serialized_list_mutex);
+		http.Get("/server_list_binary", [&](const Request& req, Response& res) {
+			auto list = get_published_list();
+
+			if (list->binary.size() > 0) {
+				const bool accepts_lz4 = req.get_header_value("Accept-Encoding").find("lz4") != std::string::npos;
+
+				/* The body depends on Accept-Encoding, so caches must not serve one encoding for the other. */
+				res.set_header("Vary", "Accept-Encoding");
+
+				if (not_modified(req, res, accepts_lz4 ? list->binary_lz4_etag : list->binary_etag)) {
+					MSR_LOG("List request arrived. The list has not changed.");
+					return;
+				}
+
+				if (accepts_lz4) {
+					MSR_LOG("List request arrived. Sending list of size: %x (%x compressed)", list->binary.size(), list->binary_lz4.size());
 
-			if (serialized_list.size() > 0) {
-				MSR_LOG("List request arrived. Sending list of size: %x", serialized_list.size());
+					res.set_header("Content-Encoding", "lz4");
+					res.set_header("X-Uncompressed-Length", std::to_string(list->binary.size()));
 
-				res.set_content_provider(
-					serialized_list.size(),
-					"application/octet-stream",
-					make_list_streamer_lambda()
-				);
+					const auto& body = list->binary_lz4;
+					send_body(res, std::move(list), body, "application/octet-stream");
+				}
+				else {
+					MSR_LOG("List request arrived. Sending list of size: %x", list->binary.size());
+
+					const auto& body = list->binary;
+					send_body(res, std::move(list), body, "application/octet-stream");
+				}
 			}
 		});
 
-		http.Get("/server_list_json", [&](const Request&, Response& res) {
-			std::shared_lock<std::shared_mutex> lock(serialized_list_mutex);
+		http.Get("/server_list_json", [&](const Request& req, Response& res) {
+			auto list = get_published_list();
 
-			if (serialized_list_json.size() > 0) {
-				MSR_LOG("JSON list request arrived. Sending list of size: %x", serialized_list_json.size());
+			if (list->json.size() > 0) {
+				if (not_modified(req, res, list->json_etag)) {
+					MSR_LOG("JSON list request arrived. The list has not changed.");
+					return;
+				}
+
+				MSR_LOG("JSON list request arrived. Sending list of size: %x", list->json.size());
 
-				res.set_content_provider(
-					serialized_list_json.size(),
-					"application/json",
-					make_json_list_streamer_lambda()
-				);
+				const auto& body = list->json;
+				send_body(res, std::move(list), body, "application/json");
 			}
 		});
 	};
@@ -578,7 +560,7 @@ void perform_masterserver(const config_lua_table& cfg) try {
 							MSR_LOG("Packet (%x bytes) from %x. New: %x. Heartbeat changed: %x.", packet_bytes, ::ToString(from), is_new_server, heartbeats_mismatch);
 
 							if (is_new_server || heartbeats_mismatch) {
-								reserialize_list();
+								reserialize_entry(from, server_entry);
 							}
 						}
 					}
@@ -691,6 +673,7 @@ void perform_masterserver(const config_lua_table& cfg) try {
 
 			if (timed_out) {
 				LOG("The server at %x (%x) has timed out.", ::ToString(server_entry.first), server_entry.second.last_heartbeat.server_name);
+				list_serializer.erase(server_entry.first);
 			}
 			else {
 				process_entry_logic(server_entry);
@@ -699,12 +682,10 @@ void perform_masterserver(const config_lua_table& cfg) try {
 			return timed_out;
 		};
 
-		const auto previous_size = server_list.size();
 		erase_if(server_list, erase_if_dead);
 
-		if (previous_size != server_list.size()) {
-			reserialize_list();
-		}
+		/* All changes from this tick go into a single snapshot. */
+		publish_list_if_changed();
 
 		yojimbo_sleep(settings.sleep_ms / 1000);
 	}
@@ -0,0 +1,18 @@
+#pragma once
+#include "augs/misc/time_utils.h"
+#include "application/masterserver/server_heartbeat.h"
+
+struct masterserver_client_meta {
+	double time_hosted;
+
+	masterserver_client_meta() {
+		time_hosted = augs::date_time::secs_since_epoch();
+	}
+};
+
+struct masterserver_client {
+	double time_last_heartbeat;
+
+	masterserver_client_meta meta;
+	server_heartbeat last_heartbeat;
+};
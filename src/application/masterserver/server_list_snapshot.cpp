@@ -0,0 +1,256 @@
+#include "augs/log.h"
+#include "augs/misc/compress.h"
+#include "augs/misc/secure_hash.h"
+#include "augs/readwrite/memory_stream.h"
+#include "augs/readwrite/byte_readwrite.h"
+#include "augs/readwrite/json_readwrite.h"
+
+#include "application/masterserver/server_list_snapshot.h"
+#include "application/masterserver/server_list_entry_json.h"
+#include "3rdparty/rapidjson/include/rapidjson/prettywriter.h"
+
+std::string ToString(const netcode_address_t&);
+
+static std::string make_etag(const std::byte* const bytes, const std::size_t n) {
+	const auto hex = std::string(augs::to_hex_format(augs::secure_hash(bytes, n)));
+
+	/* 64 bits are plenty to tell two versions of the list apart. */
+	return "\"" + hex.substr(0, 16) + "\"";
+}
+
+/* 
+	A differently encoded body is a different representation,
+	so it must not share the ETag of the identity body.
+*/
+
+static std::string make_encoded_etag(const std::string& etag, const std::string& encoding) {
+	return etag.substr(0, etag.size() - 1) + "-" + encoding + "\"";
+}
+
+static std::string to_json(const netcode_address_t& address, const masterserver_client& client) {
+	const auto& data = client.last_heartbeat;
+
+	server_list_entry_json next;
+
+	next.server_version = data.server_version;
+
+	next.name = data.server_name;
+	next.ip = ::ToString(address);
+
+	next.time_hosted = client.meta.time_hosted;
+	next.time_last_heartbeat = client.time_last_heartbeat;
+	next.arena = data.current_arena;
+	next.game_mode = data.game_mode;
+
+	next.num_spectating = data.get_num_spectators();
+	next.num_playing = data.num_online - next.num_spectating;
+
+	next.slots = data.max_online;
+
+	next.nat = data.nat.type;
+
+	if (data.internal_network_address.has_value()) {
+		next.internal_network_address = ::ToString(*data.internal_network_address);
+	}
+
+	if (data.is_editor_playtesting_server) {
+		next.is_editor_playtesting_server = data.is_editor_playtesting_server;
+	}
+
+	next.score_resistance = data.score_resistance;
+	next.score_metropolis = data.score_metropolis;
+
+	next.players_resistance = data.players_resistance;
+	next.players_metropolis = data.players_metropolis;
+	next.players_spectating = data.players_spectating;
+
+	rapidjson::StringBuffer s;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(s);
+
+	augs::write_json(writer, next);
+
+	return s.GetString();
+}
+
+server_list_serializer::server_list_serializer() : compression_state(augs::make_compression_state()) {}
+
+void server_list_serializer::update(const netcode_address_t& address, const masterserver_client& client) {
+	auto& entry = entries[address];
+
+	entry.binary.clear();
+
+	{
+		auto ss = augs::ref_memory_stream(entry.binary);
+
+		augs::write_bytes(ss, address);
+		augs::write_bytes(ss, client.meta.time_hosted);
+		augs::write_bytes(ss, client.last_heartbeat);
+	}
+
+	entry.json = ::to_json(address, client);
+
+	dirty = true;
+}
+
+void server_list_serializer::erase(const netcode_address_t& address) {
+	if (entries.erase(address) > 0) {
+		dirty = true;
+	}
+}
+
+void server_list_serializer::clear() {
+	entries.clear();
+	dirty = true;
+}
+
+server_list_snapshot_ptr server_list_serializer::make_snapshot() {
+	auto snapshot = std::make_shared<server_list_snapshot>();
+
+	std::size_t binary_size = 0;
+	std::size_t json_size = 2;
+
+	for (const auto& it : entries) {
+		binary_size += it.second.binary.size();
+		json_size += it.second.json.size() + 1;
+	}
+
+	auto& binary = snapshot->binary;
+	auto& json = snapshot->json;
+
+	binary.reserve(binary_size);
+	json.clear();
+	json.reserve(json_size);
+
+	json += '[';
+
+	for (const auto& it : entries) {
+		const auto& entry = it.second;
+
+		binary.insert(binary.end(), entry.binary.begin(), entry.binary.end());
+
+		if (json.size() > 1) {
+			json += ',';
+		}
+
+		json += entry.json;
+	}
+
+	json += ']';
+
+	augs::compress(compression_state, binary, snapshot->binary_lz4);
+
+	snapshot->binary_etag = ::make_etag(binary.data(), binary.size());
+	snapshot->binary_lz4_etag = ::make_encoded_etag(snapshot->binary_etag, "lz4");
+	snapshot->json_etag = ::make_etag(reinterpret_cast<const std::byte*>(json.data()), json.size());
+
+	snapshot->version = ++version;
+	dirty = false;
+
+	return snapshot;
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/misc/timing/timer.h"
+
+static void check_server_list_snapshots(const unsigned num_servers) {
+	auto make_address = [](const unsigned i) {
+		netcode_address_t address {};
+		address.type = NETCODE_ADDRESS_IPV4;
+		address.data.ipv4[0] = 10;
+		address.data.ipv4[1] = static_cast<uint8_t>(i >> 16);
+		address.data.ipv4[2] = static_cast<uint8_t>(i >> 8);
+		address.data.ipv4[3] = static_cast<uint8_t>(i);
+		address.port = 8412;
+
+		return address;
+	};
+
+	auto make_client = [](const unsigned i) {
+		masterserver_client client;
+
+		client.time_last_heartbeat = 0.0;
+		client.meta.time_hosted = static_cast<double>(i);
+		client.last_heartbeat.server_name = typesafe_sprintf("Server %x", i);
+		client.last_heartbeat.current_arena = "de_cyberaqua";
+		client.last_heartbeat.num_online = static_cast<uint8_t>(i % 10);
+		client.last_heartbeat.max_online = 10;
+
+		return client;
+	};
+
+	server_list_serializer serializer;
+
+	augs::timer tm;
+
+	for (unsigned i = 0; i < num_servers; ++i) {
+		serializer.update(make_address(i), make_client(i));
+	}
+
+	const auto first = serializer.make_snapshot();
+	const auto full_secs = tm.extract<std::chrono::seconds>();
+
+	REQUIRE(serializer.size() == num_servers);
+	REQUIRE(!serializer.is_dirty());
+	REQUIRE(first->binary.size() > 0);
+	REQUIRE(first->binary_lz4_etag != first->binary_etag);
+
+	{
+		const auto decompressed = augs::decompress(first->binary_lz4, first->binary.size());
+		REQUIRE(decompressed == first->binary);
+	}
+
+	/* One server changes its heartbeat. */
+
+	const auto changed_i = num_servers / 2;
+
+	auto changed = make_client(changed_i);
+	changed.last_heartbeat.num_online = 5;
+
+	tm.reset();
+
+	serializer.update(make_address(changed_i), changed);
+	const auto second = serializer.make_snapshot();
+
+	const auto incremental_secs = tm.extract<std::chrono::seconds>();
+
+	REQUIRE(second->version == first->version + 1);
+	REQUIRE(second->binary.size() == first->binary.size());
+	REQUIRE(second->binary_etag != first->binary_etag);
+	REQUIRE(second->json_etag != first->json_etag);
+
+	/* Reverting the change must bring back the exact same body and ETag. */
+
+	serializer.update(make_address(changed_i), make_client(changed_i));
+	const auto third = serializer.make_snapshot();
+
+	REQUIRE(third->binary == first->binary);
+	REQUIRE(third->json == first->json);
+	REQUIRE(third->binary_etag == first->binary_etag);
+
+	/* A snapshot held by a request is never affected by the later ones. */
+
+	serializer.erase(make_address(0));
+	const auto fourth = serializer.make_snapshot();
+
+	REQUIRE(fourth->binary.size() < third->binary.size());
+	REQUIRE(third->binary == first->binary);
+
+	LOG(
+		"Server list of %x servers: full serialization took %x ms, a snapshot after one change took %x ms (%x bytes, %x compressed).",
+		num_servers,
+		full_secs * 1000,
+		incremental_secs * 1000,
+		second->binary.size(),
+		second->binary_lz4.size()
+	);
+}
+
+TEST_CASE("Masterserver ServerListSnapshot") {
+	check_server_list_snapshots(16);
+}
+
+TEST_CASE("Masterserver ServerListSnapshotTenThousand", "[.bench]") {
+	check_server_list_snapshots(10000);
+}
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "application/masterserver/masterserver_client.h"
+#include "application/masterserver/netcode_address_hash.h"
+
+/*
+	An immutable state of the server list, exactly as it is sent over HTTP.
+	Every request holds its own shared_ptr to the snapshot for as long as it streams it,
+	so publishing a new one never copies the list nor waits for slow downloads.
+*/
+
+struct server_list_snapshot {
+	uint64_t version = 0;
+
+	std::vector<std::byte> binary;
+	std::vector<std::byte> binary_lz4;
+	std::string json = "[]";
+
+	std::string binary_etag;
+	std::string binary_lz4_etag;
+	std::string json_etag;
+};
+
+using server_list_snapshot_ptr = std::shared_ptr<const server_list_snapshot>;
+
+/*
+	Keeps every entry serialized both as bytes and as a JSON object.
+	A heartbeat reserializes only the server that has sent it,
+	and making a snapshot only concatenates what is already serialized.
+*/
+
+class server_list_serializer {
+	struct serialized_entry {
+		std::vector<std::byte> binary;
+		std::string json;
+	};
+
+	std::unordered_map<netcode_address_t, serialized_entry> entries;
+	std::vector<std::byte> compression_state;
+
+	uint64_t version = 0;
+	bool dirty = true;
+
+public:
+	server_list_serializer();
+
+	void update(const netcode_address_t&, const masterserver_client&);
+	void erase(const netcode_address_t&);
+	void clear();
+
+	bool is_dirty() const {
+		return dirty;
+	}
+
+	std::size_t size() const {
+		return entries.size();
+	}
+
+	server_list_snapshot_ptr make_snapshot();
+};
@@ -297,6 +297,13 @@ namespace net_messages {
 			{
 				auto s = buffers.make_serialization_stream<net_solvable_stream_ref>(all_flavours, clean_round_state, in.signi);
 				write_all_to(s);
+
+				LOG(
+					"Arena snapshot: delta encoding of the remaining entity pools saved %x bytes (%x skipped as unchanged, %x spent on change flags).", 
+					s.get_bytes_saved(),
+					s.bytes_skipped,
+					s.flag_bytes_added
+				);
 			}
 
 			NSR_LOG("Result stream length: %x", buffers.serialization.size());
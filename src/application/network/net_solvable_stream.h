@@ -1,4 +1,6 @@
 #pragma once
+#include "augs/templates/folded_finders.h"
+#include "augs/templates/transform_types.h"
 
 template <class V>
 constexpr bool never_changes_in_game = is_one_of_v<V,
@@ -17,6 +19,21 @@ using physics_bodies_vector = typename physics_bodies::object_pool_type;
 using dynamic_decorations = make_entity_pool<dynamic_decoration>;
 using dynamic_decorations_vector = typename dynamic_decorations::object_pool_type;
 
+template <class E>
+using make_entity_object_vector = typename make_entity_pool<E>::object_pool_type;
+
+/*
+	Objects of all other pools are sent only if they differ from the clean round state,
+	which the client already has, so a client joining mid-round
+	receives little more than what has actually happened in the round so far.
+*/
+
+template <class V>
+constexpr bool delta_encoded_in_game = 
+	is_one_of_list_v<V, transform_types_in_list_t<all_entity_types, make_entity_object_vector>>
+	&& std::is_trivially_copyable_v<typename V::value_type>
+;
+
 struct net_solvable_stream_ref : augs::ref_memory_stream {
 	using base = augs::ref_memory_stream;
 
@@ -24,6 +41,15 @@ struct net_solvable_stream_ref : augs::ref_memory_stream {
 	const cosmos_solvable_significant& initial_signi;
 	const cosmos_solvable_significant& current_signi;
 
+	/*
+		Counted only for the pools delta encoded by delta_encoded_in_game,
+		against the plain write of these pools.
+		Physics bodies and dynamic decorations are left out, since they were delta encoded long before.
+	*/
+
+	std::size_t bytes_skipped = 0;
+	std::size_t flag_bytes_added = 0;
+
 	template <class... Args>
 	net_solvable_stream_ref(
 		const all_entity_flavours& flavours,
@@ -42,7 +68,11 @@ struct net_solvable_stream_ref : augs::ref_memory_stream {
 		(void)storage;
 	}
 
-	template <class V, class NeverChanges>
+	int64_t get_bytes_saved() const {
+		return static_cast<int64_t>(bytes_skipped) - static_cast<int64_t>(flag_bytes_added);
+	}
+
+	template <bool count_savings, class V, class NeverChanges>
 	void special_write_if_changed(const V& storage, NeverChanges never_changes_pred) {
 		using E = entity_type_of<typename V::value_type>;
 
@@ -77,9 +107,18 @@ struct net_solvable_stream_ref : augs::ref_memory_stream {
 			
 			if (has_changed_byte != 0) {
 				augs::write_bytes(*this, s);
+
+				if constexpr(count_savings) {
+					flag_bytes_added += sizeof(has_changed_byte);
+				}
 			}
 			else {
-				augs::write_bytes(*this, this_id.to_unversioned());
+				const auto unversioned_id = this_id.to_unversioned();
+				augs::write_bytes(*this, unversioned_id);
+
+				if constexpr(count_savings) {
+					bytes_skipped += sizeof(s) - sizeof(unversioned_id) - sizeof(has_changed_byte);
+				}
 			}
 		}
 	}
@@ -92,7 +131,7 @@ struct net_solvable_stream_ref : augs::ref_memory_stream {
 			;
 		};
 
-		special_write_if_changed(storage, never_changes_pred);
+		special_write_if_changed<false>(storage, never_changes_pred);
 	}
 
 	void special_write(const dynamic_decorations_vector& storage) {
@@ -100,7 +139,12 @@ struct net_solvable_stream_ref : augs::ref_memory_stream {
 			return flav.template get<invariants::animation>().is_irrelevant_to_logic;
 		};
 
-		special_write_if_changed(storage, never_changes_pred);
+		special_write_if_changed<false>(storage, never_changes_pred);
+	}
+
+	template <class V, class = std::enable_if_t<delta_encoded_in_game<V>>>
+	void special_write(const V& storage) {
+		special_write_if_changed<true>(storage, [](const auto&) { return false; });
 	}
 };
 
@@ -160,6 +204,13 @@ struct net_solvable_stream_cref : augs::cref_memory_stream {
 	void special_read(dynamic_decorations_vector& storage) {
 		special_read_static_or_not(storage);
 	}
+
+	template <class V, class = std::enable_if_t<delta_encoded_in_game<V>>>
+	void special_read(V& storage) {
+		special_read_static_or_not(storage);
+	}
 };
 
 static_assert(augs::has_special_read_v<net_solvable_stream_cref, dynamic_decorations_vector>);
+static_assert(augs::has_special_read_v<net_solvable_stream_cref, make_entity_object_vector<controlled_character>>);
+static_assert(augs::has_special_write_v<net_solvable_stream_ref, make_entity_object_vector<controlled_character>>);
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "application/setups/client/arena_downloading_session.h"
 #include "application/arena/arena_paths.h"
 #include "augs/readwrite/byte_file.h"
@@ -12,10 +13,13 @@
 arena_downloading_session::arena_downloading_session(
 	const std::string& arena_name,
 	const hash_or_timestamp& project_json_hash,
-	arena_downloading_session::file_requester_type file_requester
+	arena_downloading_session::file_requester_type file_requester,
+	const std::size_t max_in_flight
 ) : 
 	arena_name(arena_name),
 	project_json_hash(project_json_hash),
+	store(DOWNLOADED_CONTENT_DIR),
+	max_in_flight(std::max(std::size_t(1), max_in_flight)),
 	file_requester(file_requester)
 {
 	part_dir_path = DOWNLOADED_ARENAS_DIR / arena_name;
@@ -33,7 +37,7 @@ arena_downloading_session::arena_downloading_session(
 }
 
 float arena_downloading_session::get_total_percent_complete(const float this_percent_complete) const {
-	const auto downloaded_index = get_downloaded_file_index();
+	const auto num_downloaded = get_downloaded_file_index();
 	const auto num_all = num_all_downloaded_files();
 
 	if (num_all == 0) {
@@ -41,11 +45,9 @@ float arena_downloading_session::get_total_percent_complete(const float this_per
 		return 0.0f;
 	}
 
-	if (num_all == 1) {
-		return this_percent_complete;
-	}
+	const auto num_in_flight = requested_files.size();
 
-	return (float(downloaded_index) + this_percent_complete) / num_all;
+	return (float(num_downloaded) + this_percent_complete * num_in_flight) / num_all;
 }
 
 void arena_downloading_session::start() {
@@ -56,10 +58,9 @@ void arena_downloading_session::start() {
 	augs::create_directories(part_dir_path);
 
 	if (try_load_json_from_part_folder()) {
-		if (const auto first_resource_to_download = next_to_download()) {
-			request_file_download(*first_resource_to_download);
-		}
-		else {
+		request_next_resources();
+
+		if (requested_files.empty()) {
 			/* 
 				Will likely never happen as it would mean the part folder was already complete.
 				But you never know.
@@ -82,6 +83,7 @@ void arena_downloading_session::start() {
 			This will only happen in the context where the file requester cares only about the path (the https downloader).
 		*/
 
+		requested_project_json = true;
 		request_file_download({ requested_project_json_hash, json_url });
 	}
 }
@@ -90,6 +92,8 @@ void arena_downloading_session::finalize_arena_download() {
 	if (const auto error = final_rearrange_directories()) {
 		last_error = *error;
 	}
+
+	store.remove_unreferenced();
 }
 
 bool arena_downloading_session::in_progress() const {
@@ -97,7 +101,7 @@ bool arena_downloading_session::in_progress() const {
 		return false;
 	}
 
-	return last_requested_file_hash.has_value();
+	return requested_project_json || !requested_files.empty();
 } 
 
 void arena_downloading_session::advance_with(
@@ -119,34 +123,35 @@ void arena_downloading_session::advance_with(
 		}
 	}
 	else {
-		ensure(last_requested_file_hash.has_value());
+		if (requested_files.empty()) {
+			last_error = std::string("The server sent a file despite no request.");
+			return;
+		}
 
-		const auto requested = *last_requested_file_hash;
-		const bool requested_hash_matches = requested == augs::secure_hash(next_received_file);
+		/* Files in flight may arrive in any order, so only their hashes tell them apart. */
 
-		if (requested_hash_matches) {
-			create_files_matching_hash(requested, next_received_file);
+		const auto actual = augs::secure_hash(next_received_file);
+		const auto found = std::find(requested_files.begin(), requested_files.end(), actual);
 
-			/* 
-				Nullopt last_requested_file_hash will mark the end of download,
-				if no more files will now be requested.
-			*/
-
-			last_requested_file_hash = std::nullopt;
-		}
-		else {
+		if (found == requested_files.end()) {
 			last_error = typesafe_sprintf(
 				"The server sent a file with an incorrect hash.\nExpected: %x\nActual: %x\n",
-				last_requested_file_hash,
-				augs::secure_hash(next_received_file)
+				requested_files.front(),
+				actual
 			);
+
+			return;
 		}
-	}
 
-	if (const auto next_resource_to_download = next_to_download()) {
-		request_file_download(*next_resource_to_download);
+		create_files_matching_hash(actual, next_received_file);
+
+		requested_files.erase(found);
+		++num_downloaded_resources;
 	}
-	else {
+
+	request_next_resources();
+
+	if (!has_error() && !in_progress()) {
 		finalize_arena_download();
 	}
 }
@@ -184,10 +189,26 @@ void arena_downloading_session::request_file_download(const hash_and_url& entry)
 	const auto& hash = entry.first;
 	const auto& url_in_provider = entry.second;
 
-	last_requested_file_hash = hash;
 	file_requester(hash, url_in_provider);
 }
 
+void arena_downloading_session::request_next_resources() {
+	while (requested_files.size() < max_in_flight && next_resource_idx < all_needed_resources.size()) {
+		const auto hash = all_needed_resources[next_resource_idx++];
+		const auto entry = mapped_or_nullptr(output_files_by_hash, hash);
+
+		if (entry == nullptr || entry->output_files.empty()) {
+			last_error = std::string("Fatal failure in request_next_resources.");
+			ensure(false && "Fatal failure in request_next_resources.");
+
+			return;
+		}
+
+		requested_files.push_back(hash);
+		request_file_download({ hash, entry->output_files[0] });
+	}
+}
+
 bool arena_downloading_session::try_load_json_from_part_folder() {
 	try {
 		const auto project_json = augs::file_to_string_crlf_to_lf(json_path_in_part_dir);
@@ -205,35 +226,6 @@ bool arena_downloading_session::try_load_json_from_part_folder() {
 	return false;
 }
 
-std::optional<arena_downloading_session::hash_and_url> arena_downloading_session::next_to_download() {
-	if (current_resource_idx == std::nullopt) {
-		current_resource_idx = 0;
-	}
-	else {
-		++(*current_resource_idx);
-	}
-
-	if (*current_resource_idx < all_needed_resources.size()) {
-		try {
-			const auto hash = all_needed_resources.at(*current_resource_idx);
-			const auto entry = output_files_by_hash.at(hash);
-
-			ensure(entry.output_files.size() > 0);
-
-			return hash_and_url(hash, entry.output_files[0]);
-		}
-		catch (...) {
-			last_error = std::string("Fatal failure in next_to_download.");
-			ensure(false && "Fatal failure in next_to_download.");
-
-			return std::nullopt;
-		}
-	}
-
-	return std::nullopt;
-}
-
-
 bool arena_downloading_session::try_find_and_paste_file_locally(
 	const augs::secure_hash_type& required_hash,
 	const augs::path_type& path_in_project
@@ -254,6 +246,19 @@ bool arena_downloading_session::try_find_and_paste_file_locally(
 	
 	}
 
+	/*
+		The same content might have been downloaded for another arena.
+	*/
+
+	try {
+		if (store.contains_valid(required_hash) && store.paste(required_hash, target_full_path)) {
+			return true;
+		}
+	}
+	catch (...) {
+
+	}
+
 	/*
 		TODO: Properly read the original arena's json and determine by hash where to look for a candidate file.
 		Only there get the path candidates and check if the hashes are indeed correct.
@@ -310,7 +315,7 @@ void arena_downloading_session::determine_needed_resources_from(const std::strin
 bool arena_downloading_session::handle_downloaded_project_json(
 	const augs::cptr_memory_stream bytes
 ) {
-	last_requested_file_hash = std::nullopt;
+	requested_project_json = false;
 
 	const auto project_json = augs::crlf_to_lf_string(bytes);
 
@@ -340,9 +345,15 @@ void arena_downloading_session::create_files_matching_hash(
 
 	ensure(entry.marked_for_download_already);
 
+	store.put(hash, bytes);
+
 	for (const auto& target_path : entry.output_files) {
 		const auto full_path = part_dir_path / target_path;
 
+		if (store.paste(hash, full_path)) {
+			continue;
+		}
+
 		augs::create_directories_for(full_path);
 		augs::bytes_to_file(bytes, full_path);
 	}
@@ -412,14 +423,10 @@ std::string arena_downloading_session::get_displayed_file_path() const {
 		return json_path_in_part_dir.filename().string();
 	}
 
-	if (current_resource_idx) {
-		if (*current_resource_idx < all_needed_resources.size()) {
-			const auto currently_downloaded_hash = all_needed_resources[*current_resource_idx];
-
-			if (const auto entry = mapped_or_nullptr(output_files_by_hash, currently_downloaded_hash)) {
-				if (entry->output_files.size() > 0) {
-					return entry->output_files[0].string();
-				}
+	if (!requested_files.empty()) {
+		if (const auto entry = mapped_or_nullptr(output_files_by_hash, requested_files.front())) {
+			if (entry->output_files.size() > 0) {
+				return entry->output_files[0].string();
 			}
 		}
 	}
@@ -9,6 +9,7 @@
 #include "augs/misc/secure_hash.h"
 #include "augs/network/network_types.h"
 #include "augs/readwrite/memory_stream_declaration.h"
+#include "application/setups/client/content_store.h"
 
 using hash_or_timestamp = std::variant<augs::secure_hash_type, version_timestamp_string>;
 
@@ -31,10 +32,15 @@ private:
 	augs::path_type target_dir_path;
 	bool arena_already_exists = false;
 
-	std::optional<augs::secure_hash_type> last_requested_file_hash;
+	content_store store;
+	std::size_t max_in_flight = 1;
+
+	bool requested_project_json = false;
+	std::vector<augs::secure_hash_type> requested_files;
 
 	std::vector<augs::secure_hash_type> all_needed_resources;
-	std::optional<std::size_t> current_resource_idx;
+	std::size_t next_resource_idx = 0;
+	std::size_t num_downloaded_resources = 0;
 
 	std::unordered_map<augs::secure_hash_type, file_hash_info> output_files_by_hash;
 	std::unordered_map<augs::secure_hash_type, augs::path_type> content_database;
@@ -48,7 +54,8 @@ public:
 	arena_downloading_session(
 		const std::string& arena_name,
 		const hash_or_timestamp& project_json_hash,
-		file_requester_type file_requester
+		file_requester_type file_requester,
+		std::size_t max_in_flight = 1
 	);
 
 	bool in_progress() const;
@@ -65,27 +72,24 @@ public:
 	}
 
 	std::size_t get_downloaded_file_index() const {
-		if (current_resource_idx) {
-			return *current_resource_idx;
-		}
-
-		return 0;
+		return num_downloaded_resources;
 	}
 
 	std::size_t num_all_downloaded_files() const {
 		return all_needed_resources.size();
 	}
 
+	/* current_file_percent is the progress of all files in flight taken together. */
 	float get_total_percent_complete(float current_file_percent) const;
 
 	std::string get_displayed_file_path() const;
 
 	bool still_downloading_project_json() const {
-		return current_resource_idx == std::nullopt;
+		return requested_project_json;
 	}
 
 	bool now_downloading_external_resources() const {
-		return current_resource_idx.has_value();
+		return !requested_files.empty();
 	}
 
 	const auto& get_arena_name() const {
@@ -100,12 +104,11 @@ private:
 	void finalize_arena_download();
 
 	void request_file_download(const hash_and_url&);
+	void request_next_resources();
 
 	void build_content_database_from_candidate_folders();
 	bool try_load_json_from_part_folder();
 
-	std::optional<hash_and_url> next_to_download();
-
 	bool handle_downloaded_project_json(augs::cptr_memory_stream);
 
 	void create_files_matching_hash(
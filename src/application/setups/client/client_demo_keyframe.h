@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+
+#include "application/setups/client/demo_file.h"
+#include "application/setups/server/server_vars.h"
+#include "application/arena/synced_dynamic_vars.h"
+#include "view/mode_gui/arena/arena_player_meta.h"
+
+/*
+	Replicated state captured periodically during demo playback,
+	so that seeking does not have to replay the demo from the very beginning.
+
+	The solvable and the mode state are written against the clean round state
+	exactly like the arena snapshot sent to joining clients, and then compressed.
+	A keyframe can only be restored while the same arena is loaded.
+*/
+
+struct client_demo_keyframe {
+	// GEN INTROSPECTOR struct client_demo_keyframe
+	demo_step_num_type step = 0;
+	double secs = 0.0;
+
+	server_public_vars sv_public_vars;
+	synced_dynamic_vars sv_dynamic_vars;
+	arena_player_metas player_metas;
+
+	std::size_t uncompressed_size = 0;
+	std::vector<std::byte> compressed_state;
+	// END GEN INTROSPECTOR
+};
+
+/*
+	Saved next to the demo so that seeking is fast from the very first seek
+	the next time the same demo is opened.
+
+	The keyframes are only valid for the exact demo file and game version they were made with,
+	otherwise the file is ignored and rebuilt during playback.
+*/
+
+struct client_demo_keyframes_file {
+	// GEN INTROSPECTOR struct client_demo_keyframes_file
+	std::string game_commit_hash;
+	std::size_t demo_file_size = 0;
+	double keyframe_interval_secs = 0.0;
+	std::vector<client_demo_keyframe> keyframes;
+	// END GEN INTROSPECTOR
+};
@@ -1,11 +1,15 @@
 #pragma once
+#include <optional>
+#include <algorithm>
 #include "application/gui/client/demo_player_gui.h"
+#include "application/setups/client/client_demo_keyframe.h"
 #include "augs/misc/timing/fixed_delta_timer.h"
 
 struct client_demo_player {
 	int additional_steps = 0;
 	std::string replay_failed_reason;
 	augs::path_type source_path;
+	std::size_t source_file_size = 0;
 	demo_player_gui gui = std::string("Player");
 	bool paused = false;
 	demo_file_meta meta;
@@ -18,6 +22,17 @@ struct client_demo_player {
 	double speed = 1.0;
 	double current_secs = 0.0;
 
+	/* 
+		Sorted by step. Seeking restores the latest one before the target.
+		Past the memory budget, every other keyframe is dropped and the interval doubles.
+	*/
+
+	std::vector<client_demo_keyframe> keyframes;
+	double keyframe_interval_secs = 10.0;
+	std::size_t max_keyframes_bytes = 256 * 1024 * 1024;
+	std::size_t stored_keyframes_bytes = 0;
+	bool keyframes_modified = false;
+
 	augs::fixed_delta_timer timer = { 30, augs::lag_spike_handling_type::CATCH_UP };
 
 	bool control(const handle_input_before_game_input in);
@@ -48,6 +63,13 @@ struct client_demo_player {
 
 	void play_demo_from(const augs::path_type& p);
 
+	augs::path_type get_keyframes_path() const {
+		return augs::path_type(source_path).replace_extension(".keyframes");
+	}
+
+	void load_keyframes();
+	void save_keyframes();
+
 	void set_speed(const double new_speed) {
 		speed = new_speed;
 	}
@@ -68,18 +90,82 @@ struct client_demo_player {
 		requested_seek = n;
 	}
 
-	template <class StepState>
-	void advance_player(StepState advance_state) {
+	template <class StepState, class SaveKeyframe>
+	void advance_player(
+		StepState advance_state,
+		SaveKeyframe save_keyframe,
+		const double inv_tickrate
+	) {
 		if (current_step < demo_steps.size()) {
 			current_secs += advance_state(demo_steps[current_step]);
 
 			++current_step;
+
+			const auto keyframe_interval = std::max(
+				demo_step_num_type(1), 
+				static_cast<demo_step_num_type>(keyframe_interval_secs / inv_tickrate)
+			);
+
+			const bool keyframe_due = 
+				current_step % keyframe_interval == 0
+				&& (keyframes.empty() || keyframes.back().step < current_step)
+			;
+
+			if (keyframe_due) {
+				if (auto new_keyframe = save_keyframe()) {
+					new_keyframe->step = current_step;
+					new_keyframe->secs = current_secs;
+
+					stored_keyframes_bytes += new_keyframe->compressed_state.size();
+					keyframes.emplace_back(std::move(*new_keyframe));
+					keyframes_modified = true;
+
+					thin_out_keyframes();
+				}
+			}
 		}
 		else {
 			current_secs += advance_state(default_step);
 		}
 	}
 
+	void thin_out_keyframes() {
+		while (stored_keyframes_bytes > max_keyframes_bytes && keyframes.size() > 1) {
+			/* 
+				Keep the odd-indexed ones, which lie on multiples of the doubled interval,
+				so the keyframes saved from now on stay evenly spaced.
+			*/
+
+			std::size_t kept = 0;
+			stored_keyframes_bytes = 0;
+
+			for (std::size_t i = 1; i < keyframes.size(); i += 2) {
+				stored_keyframes_bytes += keyframes[i].compressed_state.size();
+				keyframes[kept++] = std::move(keyframes[i]);
+			}
+
+			keyframes.resize(kept);
+			keyframe_interval_secs *= 2;
+		}
+	}
+
+	const client_demo_keyframe* find_keyframe_before(const demo_step_num_type n) const {
+		const auto it = std::upper_bound(
+			keyframes.begin(),
+			keyframes.end(),
+			n,
+			[](const demo_step_num_type step, const client_demo_keyframe& k) {
+				return step < k.step;
+			}
+		);
+
+		if (it == keyframes.begin()) {
+			return nullptr;
+		}
+
+		return std::addressof(*std::prev(it));
+	}
+
 	template <class RewindState>
 	void rewind_player(RewindState rewind_state) {
 		rewind_state();
@@ -87,23 +173,35 @@ struct client_demo_player {
 		current_secs = 0;
 	}
 
-	template <class StepState, class SeekingStepState, class RewindState>
+	template <class StepState, class SeekingStepState, class RewindState, class SaveKeyframe, class LoadKeyframe>
 	void advance(
 		augs::delta frame_delta,
 		StepState step_state, 
 		SeekingStepState seeking_step_state, 
 		RewindState rewind_state,
+		SaveKeyframe save_keyframe,
+		LoadKeyframe load_keyframe,
 		const double inv_tickrate
 	) {
 		if (requested_seek.has_value()) {
 			const auto target_step = *requested_seek;
+			const auto keyframe = find_keyframe_before(target_step);
 
-			if (target_step < current_step) {
+			const bool keyframe_skips_steps = 
+				keyframe != nullptr 
+				&& (target_step < current_step || keyframe->step > current_step)
+			;
+
+			if (keyframe_skips_steps && load_keyframe(*keyframe)) {
+				current_step = keyframe->step;
+				current_secs = keyframe->secs;
+			}
+			else if (target_step < current_step) {
 				rewind_player(rewind_state);
 			}
 
 			while (current_step < target_step) {
-				advance_player(seeking_step_state);
+				advance_player(seeking_step_state, save_keyframe, inv_tickrate);
 			}
 
 			requested_seek = std::nullopt;
@@ -120,7 +218,7 @@ struct client_demo_player {
 		}
 
 		while (steps--) {
-			advance_player(step_state);
+			advance_player(step_state, save_keyframe, inv_tickrate);
 
 			if (current_step == demo_steps.size()) {
 				pause();
@@ -130,4 +228,3 @@ struct client_demo_player {
 		additional_steps = 0;
 	}
 };
-
@@ -94,7 +94,21 @@ message_handler_result client_setup::handle_payload(
 			return continue_v;
 		}
 
-		direct_downloader = direct_file_download(*last_requested_direct_file_hash, payload.num_file_bytes);
+		const auto requested_hash = *last_requested_direct_file_hash;
+
+		direct_downloader = direct_file_download(
+			requested_hash,
+			payload.num_file_bytes,
+			get_partial_download_path(requested_hash)
+		);
+
+		/* All chunks might have been received before the download was interrupted. */
+		if (auto complete_file = direct_downloader->take_if_complete()) {
+			buffered_chunk_packets.clear();
+			handle_complete_direct_file(*complete_file);
+
+			return continue_v;
+		}
 
 		for (const auto& buffered_chunk : buffered_chunk_packets) {
 			if (direct_downloader.has_value()) {
@@ -37,6 +37,8 @@
 #include "application/gui/client/demo_player_gui.hpp"
 
 #include "application/setups/client/https_file_downloader.h"
+#include "application/setups/client/content_store.h"
+#include "all_paths.h"
 #include "application/setups/client/client_handle_payload.hpp"
 #include "application/network/resolve_address.h"
 #include "augs/network/netcode_sockets.h"
@@ -54,6 +56,8 @@ void client_demo_player::play_demo_from(const augs::path_type& p) {
 	source_path = p;
 
 	auto source_bytes = augs::file_to_bytes(source_path);
+	source_file_size = source_bytes.size();
+
 	auto source = augs::make_ptr_read_stream(source_bytes);
 	augs::read_bytes(source, meta);
 
@@ -83,10 +87,80 @@ void client_demo_player::play_demo_from(const augs::path_type& p) {
 		}
 	}
 
+	load_keyframes();
 
 	gui.open();
 }
 
+void client_demo_player::load_keyframes() {
+	const auto keyframes_path = get_keyframes_path();
+
+	if (!augs::exists(keyframes_path)) {
+		return;
+	}
+
+	client_demo_keyframes_file file;
+
+	try {
+		augs::load_from_bytes(file, keyframes_path);
+	}
+	catch (const augs::file_open_error& err) {
+		LOG("Failed to open demo keyframes: %x", err.what());
+		return;
+	}
+	catch (const augs::stream_read_error& err) {
+		LOG("Failed to read demo keyframes: %x", err.what());
+		return;
+	}
+
+	const bool up_to_date = 
+		file.game_commit_hash == hypersomnia_version().commit_hash
+		&& file.demo_file_size == source_file_size
+	;
+
+	if (!up_to_date) {
+		LOG("Ignoring %x: made for a different demo or game version.", keyframes_path);
+		return;
+	}
+
+	keyframes = std::move(file.keyframes);
+	keyframe_interval_secs = file.keyframe_interval_secs;
+	stored_keyframes_bytes = 0;
+
+	for (const auto& k : keyframes) {
+		stored_keyframes_bytes += k.compressed_state.size();
+	}
+
+	keyframes_modified = false;
+	thin_out_keyframes();
+
+	LOG("Loaded %x demo keyframes (%x) from %x.", keyframes.size(), readable_bytesize(stored_keyframes_bytes), keyframes_path);
+}
+
+void client_demo_player::save_keyframes() {
+	if (!keyframes_modified || keyframes.empty() || source_path.empty()) {
+		return;
+	}
+
+	client_demo_keyframes_file file;
+	file.game_commit_hash = hypersomnia_version().commit_hash;
+	file.demo_file_size = source_file_size;
+	file.keyframe_interval_secs = keyframe_interval_secs;
+	file.keyframes = std::move(keyframes);
+
+	const auto keyframes_path = get_keyframes_path();
+
+	try {
+		augs::save_as_bytes(file, keyframes_path);
+		keyframes_modified = false;
+	}
+	catch (const augs::file_open_error& err) {
+		LOG("Failed to save demo keyframes: %x", err.what());
+	}
+
+	keyframes = std::move(file.keyframes);
+}
+
 bool client_demo_player::control(const handle_input_before_game_input in) {
 	using namespace augs::event;
 	using namespace augs::event::keys;
@@ -161,6 +235,101 @@ void client_setup::demo_replay_server_messages_from(const demo_step& step) {
 	}
 }
 
+std::optional<client_demo_keyframe> client_setup::make_demo_keyframe() {
+	if (state != client_state_type::IN_GAME) {
+		return std::nullopt;
+	}
+
+	client_demo_keyframe keyframe;
+
+	keyframe.sv_public_vars = sv_public_vars;
+	keyframe.sv_dynamic_vars = sv_dynamic_vars;
+	keyframe.player_metas = player_metas;
+
+	const auto& signi = scene.world.get_solvable().significant;
+
+	{
+		auto s = buffers.make_serialization_stream<net_solvable_stream_ref>(
+			scene.world.get_common_significant().flavours,
+			clean_round_state,
+			signi
+		);
+
+		augs::write_bytes(s, signi);
+		augs::write_bytes(s, current_mode_state);
+		augs::write_bytes(s, client_player_id);
+	}
+
+	keyframe.uncompressed_size = buffers.serialization.size();
+	augs::compress(buffers.compression_state, buffers.serialization, keyframe.compressed_state);
+
+	return keyframe;
+}
+
+bool client_setup::load_demo_keyframe(const client_demo_keyframe& keyframe) {
+	const auto& kv = keyframe.sv_public_vars;
+
+	const bool same_arena = 
+		kv.arena == sv_public_vars.arena
+		&& kv.game_mode == sv_public_vars.game_mode
+		&& kv.required_arena_hash == sv_public_vars.required_arena_hash
+	;
+
+	if (!same_arena) {
+		return false;
+	}
+
+	auto& uncompressed_buf = buffers.serialization;
+	uncompressed_buf.resize(keyframe.uncompressed_size);
+
+	try {
+		augs::decompress(
+			keyframe.compressed_state.data(),
+			keyframe.compressed_state.size(),
+			uncompressed_buf
+		);
+	}
+	catch (const augs::decompression_error& err) {
+		LOG("Failed to decompress a demo keyframe: %x", err.what());
+		return false;
+	}
+
+	cosmic::change_solvable_significant(
+		scene.world, 
+		[&](cosmos_solvable_significant& signi) {
+			auto s = net_solvable_stream_cref(clean_round_state, uncompressed_buf);
+
+			augs::read_bytes(s, signi);
+			augs::read_bytes(s, current_mode_state);
+			augs::read_bytes(s, client_player_id);
+
+			return changer_callback_result::REFRESH;
+		}
+	);
+
+	sv_dynamic_vars = keyframe.sv_dynamic_vars;
+	player_metas = keyframe.player_metas;
+	rebuild_player_meta_viewables = true;
+
+	state = client_state_type::IN_GAME;
+
+	auto predicted = get_arena_handle(client_arena_type::PREDICTED);
+	const auto referential = get_arena_handle(client_arena_type::REFERENTIAL);
+
+	predicted.transfer_all_solvables(referential);
+
+	/* 
+		Entropies predicted before the seek would be replayed 
+		on top of the restored state during the next reprediction.
+	*/
+
+	receiver.clear();
+
+	snap_interpolated_to_logical(predicted.advanced_cosm);
+
+	return true;
+}
+
 template <class T>
 void client_setup::demo_record_server_message(T& message) {
 	if (is_recording()) {
@@ -257,12 +426,7 @@ void client_setup::handle_received(const file_chunk_packet& chunk) {
 	uint32_t data_received = 0;
 
 	if (const auto complete_file = direct_downloader->advance(chunk, data_received); complete_file.has_value()) {
-		direct_downloader = std::nullopt;
-		last_requested_direct_file_hash = std::nullopt;
-
-		if (advance_downloading_session(augs::make_ptr_read_stream(*complete_file)) == message_handler_result::ABORT_AND_DISCONNECT) {
-			schedule_disconnect = true;
-		}
+		handle_complete_direct_file(*complete_file);
 	}
 
 	if (data_received != 0) {
@@ -270,6 +434,15 @@ void client_setup::handle_received(const file_chunk_packet& chunk) {
 	}
 }
 
+void client_setup::handle_complete_direct_file(const std::vector<std::byte>& complete_file) {
+	direct_downloader = std::nullopt;
+	last_requested_direct_file_hash = std::nullopt;
+
+	if (advance_downloading_session(augs::make_ptr_read_stream(complete_file)) == message_handler_result::ABORT_AND_DISCONNECT) {
+		schedule_disconnect = true;
+	}
+}
+
 bool client_setup::handle_auxiliary_command(std::byte* const bytes, const int n) {
 	if (n != sizeof(file_chunk_packet)) {
 		return false;
@@ -402,13 +575,21 @@ client_setup::~client_setup() {
 
 	flush_demo_steps();
 	wait_for_demo_flush();
+
+	demo_player.save_keyframes();
+}
+
+augs::path_type client_setup::get_partial_download_path(const augs::secure_hash_type& hash) const {
+	return content_store(DOWNLOADED_CONTENT_DIR).get_partial_path(hash);
 }
 
 void client_setup::request_direct_file_download(const augs::secure_hash_type& hash) {
+	const bool resuming = direct_file_download::can_resume(get_partial_download_path(hash));
+
 	request_arena_file_download request;
 	request.requested_file_hash = hash;
-	/* Send a burst for the first time */
-	request.num_chunks_to_presend = calc_num_chunks_per_tick() * 2;
+	/* Send a burst for the first time, unless we resume and the burst would likely be redundant. */
+	request.num_chunks_to_presend = resuming ? 0 : calc_num_chunks_per_tick() * 2;
 	num_skip_chunks = request.num_chunks_to_presend;
 	buffered_chunk_packets.clear();
 
@@ -429,7 +610,7 @@ bool client_setup::setup_external_arena_download_session() {
 	if (const auto parsed = parsed_url(sv_public_vars.external_arena_files_provider); parsed.valid()) {
 		LOG("External arena files provider: %x", sv_public_vars.external_arena_files_provider);
 
-		external_downloader = std::make_unique<https_file_downloader>(parsed);
+		external_downloader = std::make_unique<https_file_downloader>(parsed, max_parallel_https_downloads_v);
 
 		auto external_file_requester = [this](const augs::secure_hash_type&, const augs::path_type& path) {
 			const auto location = typesafe_sprintf("%x/%x", last_download_request.arena_name, path.string());
@@ -439,7 +620,8 @@ bool client_setup::setup_external_arena_download_session() {
 		downloading = arena_downloading_session(
 			last_download_request.arena_name,
 			last_download_request.project_hash,
-			external_file_requester
+			external_file_requester,
+			max_parallel_https_downloads_v
 		);
 
 		return true;
@@ -456,6 +638,8 @@ void client_setup::setup_direct_arena_download_session() {
 
 	external_downloader = nullptr;
 
+	/* The server sends one file at a time to each client, so the files are requested one by one. */
+
 	auto direct_file_requester = [this](const augs::secure_hash_type& hash, const augs::path_type& path) {
 		LOG("Requesting direct download over UDP: %x (hash: %x)", path, hash);
 		this->request_direct_file_download(hash);
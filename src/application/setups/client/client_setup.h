@@ -233,6 +233,9 @@ class client_setup :
 
 	void demo_replay_server_messages_from(const demo_step&);
 
+	std::optional<client_demo_keyframe> make_demo_keyframe();
+	bool load_demo_keyframe(const client_demo_keyframe&);
+
 	auto make_accumulator_input(const client_advance_input& in) {
 		auto accumulator_in = in.make_accumulator_input();
 		accumulator_in.settings.character = current_requested_settings.public_settings.character_input;
@@ -573,6 +576,7 @@ class client_setup :
 	void snap_interpolation_of_viewed();
 
 	void request_direct_file_download(const augs::secure_hash_type&);
+	augs::path_type get_partial_download_path(const augs::secure_hash_type&) const;
 
 	bool setup_external_arena_download_session();
 	void setup_direct_arena_download_session();
@@ -697,11 +701,26 @@ public:
 				demo_player = std::move(player_backup);
 			};
 
+			auto save_keyframe = [&]() {
+				return make_demo_keyframe();
+			};
+
+			auto load_keyframe = [&](const client_demo_keyframe& keyframe) {
+				if (load_demo_keyframe(keyframe)) {
+					needs_snap = true;
+					return true;
+				}
+
+				return false;
+			};
+
 			demo_player.advance(
 				in.frame_delta,
 				advance_with,
 				seeking_advance,
 				rewind,
+				save_keyframe,
+				load_keyframe,
 				get_inv_tickrate()
 			);
 
@@ -850,6 +869,7 @@ public:
 	bool handle_auxiliary_command(std::byte*, int n);
 
 	void handle_received(const file_chunk_packet& chunk);
+	void handle_complete_direct_file(const std::vector<std::byte>& complete_file);
 	file_chunk_index_type calc_num_chunks_per_tick() const;
 
 	void apply_nonzoomedout_visible_world_area(vec2);
@@ -0,0 +1,140 @@
+#include "application/setups/client/content_store.h"
+#include "augs/readwrite/byte_file.h"
+#include "augs/readwrite/memory_stream.h"
+#include "augs/filesystem/directory.h"
+#include "augs/filesystem/file.h"
+#include "augs/log.h"
+
+content_store::content_store(const augs::path_type& dir) : dir(dir) {}
+
+static augs::path_type get_copied_marker_path(augs::path_type stored_path) {
+	stored_path += ".copied";
+	return stored_path;
+}
+
+static void set_writable(const augs::path_type& path, const bool flag) {
+	using namespace std::filesystem;
+
+	const auto write_perms = perms::owner_write | perms::group_write | perms::others_write;
+
+	std::error_code err;
+	permissions(path, flag ? perms::owner_write : write_perms, flag ? perm_options::add : perm_options::remove, err);
+}
+
+static void remove_even_if_read_only(const augs::path_type& path) {
+	/* Some platforms refuse to remove read-only files. */
+	set_writable(path, true);
+	augs::remove_file(path);
+}
+
+augs::path_type content_store::get_path(const augs::secure_hash_type& hash) const {
+	return dir / std::string(augs::to_hex_format(hash));
+}
+
+augs::path_type content_store::get_partial_path(const augs::secure_hash_type& hash) const {
+	auto path = get_path(hash);
+	path += ".part";
+	return path;
+}
+
+bool content_store::contains_valid(const augs::secure_hash_type& hash) const {
+	const auto path = get_path(hash);
+
+	if (!augs::exists(path)) {
+		return false;
+	}
+
+	try {
+		if (hash == augs::secure_hash(augs::file_to_bytes(path))) {
+			return true;
+		}
+
+		LOG("Stored content at %x does not match its hash. Removing.", path);
+	}
+	catch (...) {
+
+	}
+
+	remove_even_if_read_only(path);
+	return false;
+}
+
+void content_store::put(const augs::secure_hash_type& hash, const augs::cptr_memory_stream bytes) const {
+	const auto path = get_path(hash);
+
+	auto temporary_path = path;
+	temporary_path += ".tmp";
+
+	try {
+		augs::create_directories(dir);
+		augs::bytes_to_file(bytes, temporary_path);
+		std::filesystem::rename(temporary_path, path);
+	}
+	catch (const std::exception& err) {
+		LOG("Failed to store content at %x: %x", path, err.what());
+		augs::remove_file(temporary_path);
+	}
+}
+
+bool content_store::paste(const augs::secure_hash_type& hash, const augs::path_type& target_path) const {
+	const auto path = get_path(hash);
+
+	augs::create_directories_for(target_path);
+	remove_even_if_read_only(target_path);
+
+	std::error_code err;
+	std::filesystem::create_hard_link(path, target_path, err);
+
+	if (!err) {
+		set_writable(path, false);
+		return true;
+	}
+
+	std::filesystem::copy_file(path, target_path, err);
+
+	if (err) {
+		return false;
+	}
+
+	set_writable(target_path, true);
+
+	/* The copy does not raise the link count of the stored file. */
+	try {
+		augs::save_as_text(get_copied_marker_path(path), "");
+	}
+	catch (const std::exception& marker_err) {
+		LOG("Failed to mark %x as copied: %x", path, marker_err.what());
+	}
+
+	return true;
+}
+
+void content_store::remove_unreferenced() const {
+	if (!augs::exists(dir)) {
+		return;
+	}
+
+	try {
+		augs::for_each_in_directory(
+			dir,
+			[](const auto&) { return callback_result::CONTINUE; },
+			[&](const auto& path) {
+				/* Partial downloads have an extension and are kept until they complete. */
+				if (path.has_extension()) {
+					return callback_result::CONTINUE;
+				}
+
+				std::error_code err;
+
+				if (std::filesystem::hard_link_count(path, err) == 1 && !augs::exists(get_copied_marker_path(path))) {
+					remove_even_if_read_only(path);
+				}
+
+				return callback_result::CONTINUE;
+			}
+		);
+	}
+	catch (const std::exception& err) {
+		LOG("Failed to clean the content store at %x: %x", dir, err.what());
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "augs/filesystem/path.h"
+#include "augs/misc/secure_hash.h"
+#include "augs/readwrite/memory_stream_declaration.h"
+
+/*
+	Downloaded arena resources, each stored once under the name of its hash,
+	so that a resource shared by many arenas is downloaded only once.
+
+	Arenas get hard links to the stored files wherever the filesystem allows it,
+	and copies otherwise.
+	Linked files are made read-only, since writing to one in place
+	would change the stored file and every other arena linking to it.
+
+	A stored file that no arena links to anymore can be removed.
+	Copies cannot be tracked, so a stored file that was ever copied out
+	is marked as such and always kept.
+
+	Partially received files are kept here as well, so that an interrupted download can resume.
+*/
+
+class content_store {
+	augs::path_type dir;
+
+public:
+	content_store(const augs::path_type& dir);
+
+	augs::path_type get_path(const augs::secure_hash_type&) const;
+	augs::path_type get_partial_path(const augs::secure_hash_type&) const;
+
+	/* Removes the stored file if its contents do not match the hash. */
+	bool contains_valid(const augs::secure_hash_type&) const;
+
+	void put(const augs::secure_hash_type&, augs::cptr_memory_stream bytes) const;
+	bool paste(const augs::secure_hash_type&, const augs::path_type& target_path) const;
+
+	void remove_unreferenced() const;
+};
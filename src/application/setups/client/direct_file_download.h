@@ -1,6 +1,8 @@
 #pragma once
+#include <fstream>
 #include "application/setups/server/file_chunk_packet.h"
 #include "augs/misc/randomization.h"
+#include "augs/filesystem/path.h"
 
 struct direct_file_chunk_meta {
 	double last_sent = 0.0;
@@ -23,13 +25,41 @@ class direct_file_download {
 	uint32_t next_requested_chunk = 0;
 	void reshuffle();
 
+	/*
+		Received chunks are also written to a partial file,
+		together with a bitmap of which chunks it already has,
+		so that an interrupted download resumes where it stopped.
+
+		The bitmap is saved only after the file is flushed,
+		so it never claims a chunk that is not on the disk yet.
+	*/
+
+	augs::path_type partial_path;
+	std::fstream partial_file;
+	std::vector<uint8_t> received_bitmap;
+	uint32_t chunks_since_saved_bitmap = 0;
+
+	augs::path_type get_bitmap_path() const;
+
+	bool is_received(file_chunk_index_type) const;
+	void mark_received(file_chunk_index_type);
+
+	bool try_resume();
+	void open_partial_file();
+	void save_bitmap();
+	void remove_partial_files();
+
 public:
 	direct_file_download(
 		augs::secure_hash_type hash,
-		uint32_t num_file_bytes
+		uint32_t num_file_bytes,
+		const augs::path_type& partial_path
 	);
 
 	std::optional<std::vector<std::byte>> advance(const file_chunk_packet&, uint32_t& data_received);
+	std::optional<std::vector<std::byte>> take_if_complete();
+
+	static bool can_resume(const augs::path_type& partial_path);
 
 	direct_file_chunk_meta& request_next_chunk();
 
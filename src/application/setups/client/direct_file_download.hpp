@@ -1,10 +1,16 @@
 #pragma once
 #include "application/setups/client/direct_file_download.h"
+#include "augs/readwrite/byte_file.h"
+#include "augs/filesystem/directory.h"
+
+/* Roughly every 256 KB. */
+constexpr uint32_t save_chunk_bitmap_once_every_v = 256;
 
 direct_file_download::direct_file_download(
 	augs::secure_hash_type hash,
-	uint32_t num_file_bytes
-) : current_hash(hash), target_file_size(num_file_bytes) {
+	uint32_t num_file_bytes,
+	const augs::path_type& partial_path
+) : current_hash(hash), target_file_size(num_file_bytes), partial_path(partial_path) {
 	ensure(num_file_bytes < max_direct_download_file_size_v);
 	ensure(num_file_bytes > 0);
 
@@ -14,13 +20,145 @@ direct_file_download::direct_file_download(
 		++num_chunks_total;
 	}
 
-	chunks.resize(num_chunks_total);
+	file_bytes.resize(num_chunks_total * file_chunk_size_v);
+	received_bitmap.resize((num_chunks_total + 7) / 8);
+
+	const bool resumed = try_resume();
+
+	chunks.reserve(num_chunks_total);
 
 	for (uint32_t i = 0; i < num_chunks_total; ++i) {
-		chunks[i].index = i;
+		const auto index = static_cast<file_chunk_index_type>(i);
+
+		if (is_received(index)) {
+			++num_chunks_downloaded;
+		}
+		else {
+			direct_file_chunk_meta meta;
+			meta.index = index;
+
+			chunks.push_back(meta);
+		}
 	}
 
-	file_bytes.resize(num_chunks_total * file_chunk_size_v);
+	if (resumed) {
+		LOG("Resuming the download of %x: %x of %x chunks already received.", partial_path, num_chunks_downloaded, num_chunks_total);
+	}
+
+	open_partial_file();
+}
+
+bool direct_file_download::can_resume(const augs::path_type& partial_path) {
+	return augs::exists(partial_path);
+}
+
+augs::path_type direct_file_download::get_bitmap_path() const {
+	auto path = partial_path;
+	path += ".chunks";
+	return path;
+}
+
+bool direct_file_download::is_received(const file_chunk_index_type index) const {
+	return (received_bitmap[index / 8] >> (index % 8)) & 1;
+}
+
+void direct_file_download::mark_received(const file_chunk_index_type index) {
+	received_bitmap[index / 8] |= static_cast<uint8_t>(1 << (index % 8));
+}
+
+bool direct_file_download::try_resume() {
+	const auto bitmap_path = get_bitmap_path();
+
+	if (!augs::exists(partial_path) || !augs::exists(bitmap_path)) {
+		return false;
+	}
+
+	try {
+		if (std::filesystem::file_size(partial_path) != target_file_size) {
+			return false;
+		}
+
+		const auto saved_bitmap = augs::file_to_bytes(bitmap_path);
+
+		if (saved_bitmap.size() != received_bitmap.size()) {
+			return false;
+		}
+
+		auto source = augs::open_binary_input_stream(partial_path);
+		source.read(reinterpret_cast<char*>(file_bytes.data()), target_file_size);
+
+		std::memcpy(received_bitmap.data(), saved_bitmap.data(), saved_bitmap.size());
+
+		return true;
+	}
+	catch (...) {
+		std::fill(received_bitmap.begin(), received_bitmap.end(), uint8_t(0));
+	}
+
+	return false;
+}
+
+void direct_file_download::open_partial_file() {
+	try {
+		if (num_chunks_downloaded == 0) {
+			augs::remove_file(get_bitmap_path());
+			augs::create_directories_for(partial_path);
+
+			{
+				auto created = augs::open_binary_output_stream(partial_path);
+			}
+
+			std::filesystem::resize_file(partial_path, target_file_size);
+		}
+	}
+	catch (const std::exception& err) {
+		LOG("Could not create %x. The download will not be resumable: %x", partial_path, err.what());
+		return;
+	}
+
+	partial_file.open(partial_path, std::ios::in | std::ios::out | std::ios::binary);
+
+	if (!partial_file.is_open()) {
+		LOG("Could not open %x. The download will not be resumable.", partial_path);
+	}
+}
+
+void direct_file_download::save_bitmap() {
+	chunks_since_saved_bitmap = 0;
+
+	partial_file.flush();
+
+	if (!partial_file) {
+		LOG("Failed to write to %x. The download will not be resumable.", partial_path);
+
+		partial_file.close();
+		return;
+	}
+
+	try {
+		augs::bytes_to_file(received_bitmap, get_bitmap_path());
+	}
+	catch (...) {
+
+	}
+}
+
+void direct_file_download::remove_partial_files() {
+	partial_file.close();
+
+	augs::remove_file(partial_path);
+	augs::remove_file(get_bitmap_path());
+}
+
+std::optional<std::vector<std::byte>> direct_file_download::take_if_complete() {
+	if (!chunks.empty()) {
+		return std::nullopt;
+	}
+
+	remove_partial_files();
+
+	file_bytes.resize(target_file_size);
+	return std::move(file_bytes);
 }
 
 void direct_file_download::reshuffle() {
@@ -79,11 +217,20 @@ std::optional<std::vector<std::byte>> direct_file_download::advance(const file_c
 		file_chunk_size_v
 	);
 
-	if (chunks.empty()) {
-		file_bytes.resize(target_file_size);
-		return std::move(file_bytes);
+	mark_received(payload.index);
+
+	if (partial_file.is_open()) {
+		const auto offset = std::size_t(payload.index) * file_chunk_size_v;
+		const auto num_bytes = std::min(file_chunk_size_v, std::size_t(target_file_size) - offset);
+
+		partial_file.seekp(static_cast<std::streamoff>(offset));
+		partial_file.write(reinterpret_cast<const char*>(payload.chunk_bytes.data()), static_cast<std::streamsize>(num_bytes));
+
+		if (++chunks_since_saved_bitmap >= save_chunk_bitmap_once_every_v) {
+			save_bitmap();
+		}
 	}
 
-	return std::nullopt;
+	return take_if_complete();
 }
 
@@ -9,12 +9,15 @@ std::string to_forward_slashes(std::string in_str);
 double yojimbo_time();
 
 https_file_downloader::https_file_downloader(
-	const parsed_url& parent_folder_url
+	const parsed_url& parent_folder_url,
+	const std::size_t num_workers
 ) : parsed(parent_folder_url), keepRunning(true) {
 
-	downloadThread = std::thread([this]() { 
-		worker_func(); 
-	});
+	for (std::size_t i = 0; i < std::max(std::size_t(1), num_workers); ++i) {
+		downloadThreads.emplace_back([this]() { 
+			worker_func(); 
+		});
+	}
 }
 
 void https_file_downloader::worker_func() {
@@ -48,26 +51,38 @@ void https_file_downloader::worker_func() {
 			const auto final_location = to_forward_slashes(parsed.location + "/" + path);
 			LOG("HTTP downloader: requesting file at location: %x", final_location);
 
-			downloadedBytes = 0;
+			/* With many workers, the progress is summed over all files in flight. */
+			std::size_t this_downloaded = 0;
+			std::size_t this_total = 0;
 
 			auto res = client.Get(
 				final_location.c_str(), 
-				[this](std::size_t data_length, std::size_t total_length) {
-					const auto dt = data_length - downloadedBytes;
-					downloadedBytes = data_length;
-					totalBytes = total_length;
+				[this, &this_downloaded, &this_total](std::size_t data_length, std::size_t total_length) {
+					const auto dt = data_length - this_downloaded;
+
+					downloadedBytes += dt;
+					totalBytes += total_length - this_total;
+
+					this_downloaded = data_length;
+					this_total = total_length;
 
 					if (!keepRunning.load()) {
 						LOG("HTTP downloader: interrupting download.");
 						return false;
 					}
 
-					bandwidth.newDataReceived(dt);
+					{
+						std::lock_guard<std::mutex> lock(bandwidthMutex);
+						bandwidth.newDataReceived(dt);
+					}
 
 					return true;
 				}
 			);
 
+			downloadedBytes -= this_downloaded;
+			totalBytes -= this_total;
+
 			if (res && httplib_utils::successful(res->status)) {
 				std::lock_guard<std::mutex> lock(downloadedFilesMutex);
 				downloadedFiles.emplace_back(path, std::move(res->body));
@@ -91,9 +106,6 @@ void https_file_downloader::download_file(const std::string& path) {
 	{
 		std::lock_guard<std::mutex> lock(queueMutex);
 		downloadQueue.push(path);
-
-		totalBytes = 0;
-		downloadedBytes = 0;
 	}
 
 	queueCondition.notify_one(); // notify the worker thread
@@ -111,9 +123,12 @@ std::optional<std::pair<std::string, std::string>> https_file_downloader::get_do
 
 https_file_downloader::~https_file_downloader() {
 	keepRunning = false;
-	queueCondition.notify_all(); // notify the worker thread
-	if (downloadThread.joinable()) {
-		downloadThread.join();
+	queueCondition.notify_all(); // notify the worker threads
+
+	for (auto& t : downloadThreads) {
+		if (t.joinable()) {
+			t.join();
+		}
 	}
 }
 
@@ -12,6 +12,13 @@
 
 #include "application/setups/client/bandwidth_monitor.h"
 
+/*
+	Each worker has its own connection, so this many files can be downloaded at once.
+	The downloaded files may then arrive in any order.
+*/
+
+constexpr std::size_t max_parallel_https_downloads_v = 4;
+
 class https_file_downloader {
 	parsed_url parsed;
 
@@ -26,8 +33,9 @@ class https_file_downloader {
 	std::atomic_size_t downloadedBytes = 0;
 
 	BandwidthMonitor bandwidth;
+	mutable std::mutex bandwidthMutex;
 
-	std::thread downloadThread;
+	std::vector<std::thread> downloadThreads;
 
 	void worker_func();
 
@@ -47,9 +55,10 @@ public:
 	}
 
 	double get_bandwidth() const {
+		std::lock_guard<std::mutex> lock(bandwidthMutex);
 		return bandwidth.getAverageSpeed();
 	}
 
-	https_file_downloader(const parsed_url& parent_folder_url);
+	https_file_downloader(const parsed_url& parent_folder_url, std::size_t num_workers = 1);
 	~https_file_downloader();
 };
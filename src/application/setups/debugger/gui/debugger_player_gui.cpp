@@ -98,20 +98,16 @@ void debugger_player_gui::perform(const debugger_command_input cmd_in) {
 
 		const auto& snapshots = player.get_snapshots();
 
-		std::size_t total_snapshot_bytes = 0;
-
-		for (const auto& s : snapshots) {
-			total_snapshot_bytes += s.second.size();
-		}
-
-		text("Snapshots: %x (%x)", snapshots.size(), readable_bytesize(total_snapshot_bytes));
-
-		if (snapshots.size() > 0) {
-			auto it = snapshots.upper_bound(player.get_current_step());
-			--it;
-
-			const auto dist = std::distance(snapshots.begin(), it);
-			text("Current snapshot: %x (step: %x)", dist, (*it).first); 
+		text(
+			"Snapshots: %x, %x keyframes (%x, %x uncompressed)", 
+			snapshots.size(), 
+			snapshots.count_keyframes(),
+			readable_bytesize(snapshots.get_stored_bytes()),
+			readable_bytesize(snapshots.get_uncompressed_bytes())
+		);
+
+		if (const auto step = snapshots.find_at_or_before(player.get_current_step())) {
+			text("Current snapshot: %x (step: %x)", snapshots.index_of(*step), *step); 
 		}
 	}
 
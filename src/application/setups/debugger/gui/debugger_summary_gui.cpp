@@ -57,14 +57,19 @@ void debugger_summary_gui::perform(debugger_setup& setup) {
 				input_buf.clear();
 				compressed_buf.clear();
 
+				int64_t bytes_saved = 0;
+
 				{
 					const auto& clean_round_state = setup.is_gameplay_on() ? setup.get_arena_handle().clean_round_state : solvable;
 
 					auto s = net_solvable_stream_ref(cosm.get_common_significant().flavours, clean_round_state, solvable, input_buf);
 					augs::write_bytes(s, solvable);
+
+					bytes_saved = s.get_bytes_saved();
 				}
 
 				text("\n(Net) Solvable size: %x", readable_bytesize(input_buf.size()));
+				text("Saved by delta encoding the remaining pools: %x bytes", bytes_saved);
 
 				text("Raw write time: %x ms", t.template get<std::chrono::milliseconds>());
 
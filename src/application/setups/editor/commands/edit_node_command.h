@@ -37,6 +37,15 @@ struct edit_node_command {
 	}
 };
 
+template <class T>
+struct is_edit_node_command : std::false_type {};
+
+template <class N>
+struct is_edit_node_command<edit_node_command<N>> : std::true_type {};
+
+template <class T>
+constexpr bool is_edit_node_command_v = is_edit_node_command<T>::value;
+
 struct change_resource_command {
 	editor_command_meta meta;
 
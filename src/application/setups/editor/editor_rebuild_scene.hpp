@@ -8,6 +8,25 @@
 
 #include "application/arena/arena_handle.h"
 #include "application/arena/build_arena_from_editor_project.h"
+#include "application/setups/editor/editor_rebuild_node.hpp"
+#include "game/cosmos/create_entity.hpp"
+
+/*
+	Nodes whose entities depend only on the node itself and its resource.
+	Equipment is generated with a logic step, prefabs span many entities,
+	and zones might have per-node flavours or link to other nodes.
+*/
+
+template <class N>
+constexpr bool can_patch_node_in_place_v = !is_one_of_v<N,
+	editor_firearm_node,
+	editor_melee_node,
+	editor_explosive_node,
+	editor_tool_node,
+	editor_ammunition_node,
+	editor_prefab_node,
+	editor_area_marker_node
+>;
 
 void editor_setup::rebuild_arena(const bool editor_preview) {
 	const bool for_playtesting = true;
@@ -29,3 +48,133 @@ void editor_setup::rebuild_arena(const bool editor_preview) {
 
 	inspected_to_entity_selector_state();
 }
+
+/*
+	Recreates the entities of the touched nodes so that the scene looks
+	as if it was built from the project with build_arena_from_editor_project.
+	Returns false if any of the nodes could not be patched, in which case the whole arena has to be rebuilt.
+*/
+
+inline bool patch_arena_nodes(
+	cosmos& cosm,
+	const editor_project& project,
+	const packaged_official_content& official,
+	const std::vector<editor_node_id>& touched_nodes
+) {
+	auto find_resource = project.make_find_resource_lambda(official.resources);
+
+	auto get_asset_id_of = [&]<typename R>(const editor_typed_resource_id<R>& resource_id) {
+		using asset_type = decltype(R::scene_asset_id);
+
+		if (const auto resource = find_resource(resource_id)) {
+			return resource->scene_asset_id;
+		}
+
+		return asset_type();
+	};
+
+	/*
+		The entity is deleted and brought back under the same id,
+		as if it was created from scratch.
+		This way nothing that refers to it has to be updated.
+	*/
+
+	auto patch_node = [&]<typename N>(const N& node, const editor_node_id node_id) {
+		const auto parent = project.find_parent_layer(node_id);
+
+		if (parent == std::nullopt || parent->layer_ptr == nullptr) {
+			return false;
+		}
+
+		const auto resource = find_resource(node.resource_id);
+
+		if (resource == nullptr) {
+			return false;
+		}
+
+		const auto handle = cosm[node.scene_entity_id];
+
+		if (handle.dead()) {
+			return false;
+		}
+
+		bool patched = false;
+
+		handle.dispatch([&](const auto typed_handle) {
+			const auto previous_id = typed_handle.get_id();
+
+			const auto order = [&]() {
+				if (const auto sorting_order = typed_handle.template find<components::sorting_order>()) {
+					return sorting_order->order;
+				}
+
+				return sorting_order_type(0);
+			}();
+
+			auto fresh_content = typed_handle.get({});
+			fresh_content.component_state = typed_handle.get_flavour().initial_components;
+			fresh_content.when_born = {};
+
+			const auto undo_delete_input = cosmic::delete_entity(handle);
+
+			if (undo_delete_input == std::nullopt) {
+				return;
+			}
+
+			auto respawned = cosmic::undo_delete_entity(cosm, *undo_delete_input, fresh_content, reinference_type::NONE);
+			ensure(respawned.get_id() == previous_id);
+
+			::setup_entity_from_node(
+				get_asset_id_of,
+				find_resource,
+				order,
+				*parent->layer_ptr,
+				node,
+				*resource,
+				respawned,
+				respawned.get({})
+			);
+
+			construct_pre_inference(respawned);
+			cosmic::infer_caches_for(respawned);
+			construct_post_inference(respawned);
+
+			::setup_entity_from_node_post_construct(node, *resource, respawned);
+
+			patched = true;
+		});
+
+		return patched;
+	};
+
+	for (const auto& node_id : touched_nodes) {
+		bool patched = false;
+
+		project.on_node(node_id, [&]<typename N>(const N& node, const auto) {
+			if constexpr(can_patch_node_in_place_v<N>) {
+				patched = patch_node(node, node_id);
+			}
+		});
+
+		if (!patched) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool editor_setup::try_patch_arena(const std::vector<editor_node_id>& touched_nodes) {
+	if (!::patch_arena_nodes(scene.world, project, official, touched_nodes)) {
+		return false;
+	}
+
+	/*
+		The clean round state is not refreshed here.
+		Playtesting takes a fresh copy of the scene before it starts anyway.
+	*/
+
+	inspected_to_entity_selector_state();
+
+	return true;
+}
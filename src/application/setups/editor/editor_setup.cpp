@@ -3822,3 +3822,93 @@ template struct create_node_command<editor_prefab_node>;
 
 #include "application/network/network_common.h"
 template void build_arena_from_editor_project<online_arena_handle<false>>(online_arena_handle<false> arena_handle, build_arena_input);
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "all_paths.h"
+#include "augs/misc/lua/lua_utils.h"
+
+TEST_CASE("EditorSetup PatchedArenaMatchesRebuilt") {
+	/* Moves a sprite node, patches its entity and compares the scene against one built from scratch. */
+
+	auto lua = augs::create_lua_state();
+	const auto official = packaged_official_content(lua);
+
+	const auto arena_folder = OFFICIAL_ARENAS_DIR / "fy_minilab";
+
+	auto project = editor_project_readwrite::read_project_json(
+		arena_folder / "fy_minilab.json",
+		official.resources,
+		official.resource_map
+	);
+
+	struct built_arena {
+		intercosm scene;
+		all_rulesets_variant ruleset;
+		all_modes_variant current_mode_state;
+		cosmos_solvable_significant clean_round_state;
+		synced_dynamic_vars dynamic_vars;
+
+		auto get_arena_handle() {
+			return online_arena_handle<false> {
+				current_mode_state,
+				scene,
+				scene.world,
+				ruleset,
+				clean_round_state,
+				dynamic_vars
+			};
+		}
+	};
+
+	auto build = [&](built_arena& arena) {
+		const bool for_playtesting = true;
+		const bool editor_preview = true;
+
+		::build_arena_from_editor_project(
+			arena.get_arena_handle(),
+			{
+				project,
+				game_mode_name_type(""),
+				arena_folder,
+				official,
+				nullptr,
+				std::addressof(arena.clean_round_state),
+				for_playtesting,
+				editor_preview
+			}
+		);
+	};
+
+	auto patched = std::make_unique<built_arena>();
+	build(*patched);
+
+	std::optional<editor_node_id> moved_node;
+
+	project.nodes.pools.get_for<editor_sprite_node>().for_each_id_and_object(
+		[&](const auto& raw_id, editor_sprite_node& node) {
+			if (!moved_node.has_value() && patched->scene.world[node.scene_entity_id].alive()) {
+				node.editable.pos += vec2(32, 0);
+				moved_node = editor_node_id(editor_typed_node_id<editor_sprite_node>::from_raw(raw_id));
+			}
+		}
+	);
+
+	REQUIRE(moved_node.has_value());
+
+	augs::timer tm;
+	REQUIRE(::patch_arena_nodes(patched->scene.world, project, official, { *moved_node }));
+	const auto patch_ms = tm.extract<std::chrono::milliseconds>();
+
+	auto rebuilt = std::make_unique<built_arena>();
+	build(*rebuilt);
+	const auto rebuild_ms = tm.extract<std::chrono::milliseconds>();
+
+	LOG("Moving a node of fy_minilab: patching took %x ms, rebuilding took %x ms.", patch_ms, rebuild_ms);
+
+	REQUIRE(
+		patched->scene.world.calculate_solvable_signi_hash<uint32_t>() 
+		== rebuilt->scene.world.calculate_solvable_signi_hash<uint32_t>()
+	);
+}
+#endif
@@ -134,6 +134,13 @@ class editor_setup : public default_setup_settings, public arena_gui_mixin<edito
 
 	scene_entity_to_node_map scene_entity_to_node;
 
+	struct scene_update_info {
+		double ms = 0.0;
+		std::size_t num_patched_nodes = 0;
+	};
+
+	scene_update_info last_scene_update;
+
 	editor_project project;
 	editor_gui gui;
 	editor_view view;
@@ -520,6 +527,14 @@ public:
 	bool handle_doubleclick_in_layers_gui = false;
 
 	void rebuild_arena(const bool editor_preview = true);
+	bool try_patch_arena(const std::vector<editor_node_id>& touched_nodes);
+
+	template <class T>
+	void update_arena_after(const T& command);
+
+	const auto& get_last_scene_update() const {
+		return last_scene_update;
+	}
 
 	const auto& get_paths() const {
 		return paths;
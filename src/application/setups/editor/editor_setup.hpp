@@ -2,6 +2,7 @@
 #include "application/setups/editor/editor_setup.h"
 #include "application/setups/editor/resources/editor_typed_resource_id.h"
 #include "application/setups/editor/project/editor_project.hpp"
+#include "augs/misc/timing/timer.h"
 
 template <class T>
 constexpr bool skip_scene_rebuild_v = is_one_of_v<T,
@@ -36,7 +37,7 @@ const T& editor_setup::post_new_command(T&& command) {
 	const T& result = history.execute_new(std::forward<T>(command), make_command_input(true));
 
 	if constexpr(!skip_scene_rebuild_v<T>) {
-		rebuild_arena();
+		update_arena_after(result);
 	}
 
 	if constexpr(!skip_missing_resources_check_v<T>) {
@@ -63,7 +64,7 @@ const T& editor_setup::rewrite_last_command(T&& command) {
 	history.undo(make_command_input(true));
 	const T& result = history.execute_new(std::forward<T>(command), make_command_input(true));
 
-	rebuild_arena(); 
+	update_arena_after(result);
 
 	if constexpr(!skip_missing_resources_check_v<remove_cref<T>>) {
 		on_resource_references_changed();
@@ -72,6 +73,40 @@ const T& editor_setup::rewrite_last_command(T&& command) {
 	return result;
 }
 
+template <class T>
+void editor_setup::update_arena_after(const T& command) {
+	auto tm = augs::timer();
+
+	last_scene_update = {};
+
+	/*
+		Only the entities of the touched nodes are recreated if possible.
+		Everything else still rebuilds the whole arena.
+	*/
+
+	if constexpr(is_edit_node_command_v<T>) {
+		thread_local std::vector<editor_node_id> touched_nodes;
+		touched_nodes.clear();
+
+		for (const auto& entry : command.entries) {
+			touched_nodes.push_back(entry.node_id.operator editor_node_id());
+		}
+
+		if (try_patch_arena(touched_nodes)) {
+			last_scene_update.num_patched_nodes = touched_nodes.size();
+		}
+		else {
+			rebuild_arena();
+		}
+	}
+	else {
+		(void)command;
+		rebuild_arena();
+	}
+
+	last_scene_update.ms = tm.get<std::chrono::milliseconds>();
+}
+
 template <class R, class F>
 void editor_setup::for_each_resource(F&& callback, bool for_official) const {
 	const auto& pools = for_official ? get_official_resources() : project.resources;
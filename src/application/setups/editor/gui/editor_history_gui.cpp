@@ -31,6 +31,17 @@ void editor_history_gui::perform(const editor_history_gui_input in) {
 	thread_local ImGuiTextFilter filter;
 	filter_with_hint(filter, "##HistoryFilter", "Search history...");
 
+	if (ImGui::IsItemHovered()) {
+		const auto& update = in.setup.get_last_scene_update();
+
+		if (update.num_patched_nodes > 0) {
+			text_tooltip("Last command updated %x node(s) in %2f ms.", update.num_patched_nodes, update.ms);
+		}
+		else {
+			text_tooltip("Last command rebuilt the scene in %2f ms.", update.ms);
+		}
+	}
+
 	const auto avail = ImGui::GetContentRegionAvail().x;
 
 	ImGui::Columns(2);
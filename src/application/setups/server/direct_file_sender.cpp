@@ -0,0 +1,320 @@
+#include <chrono>
+#include <algorithm>
+
+#include "application/setups/server/direct_file_sender.h"
+
+direct_file_sender::direct_file_sender() {
+	worker = std::thread([this]() {
+		worker_func();
+	});
+}
+
+direct_file_sender::~direct_file_sender() {
+	{
+		std::scoped_lock lk(mutex);
+		keep_running = false;
+	}
+
+	wake.notify_one();
+	worker.join();
+}
+
+std::size_t direct_file_sender::calc_num_chunks(const std::size_t file_size) {
+	if (file_size == 0) {
+		return 1;
+	}
+
+	return (file_size + file_chunk_size_v - 1) / file_chunk_size_v;
+}
+
+direct_file_sender::fill_result direct_file_sender::fill_packet(
+	file_chunk_packet& packet,
+	const augs::readonly_file& file,
+	const file_chunk_index_type index
+) {
+	const auto bytes_n = file.size();
+	const auto last_chunk_index = calc_num_chunks(bytes_n) - 1;
+
+	if (index > last_chunk_index) {
+		return fill_result::INVALID_INDEX;
+	}
+
+	const bool is_last_chunk = index == last_chunk_index;
+
+	const auto bytes_start = std::size_t(index) * file_chunk_size_v;
+	const auto bytes_end   = is_last_chunk ? bytes_n : (bytes_start + file_chunk_size_v);
+
+	const auto bytes_copied = bytes_end - bytes_start;
+
+	packet.index = index;
+
+	if (!file.read(bytes_start, packet.chunk_bytes.data(), bytes_copied)) {
+		return fill_result::FILE_CHANGED;
+	}
+
+	std::fill(packet.chunk_bytes.begin() + bytes_copied, packet.chunk_bytes.end(), std::byte(0));
+
+	return fill_result::OK;
+}
+
+void direct_file_sender::set_socket(const std::optional<netcode_socket_t> new_socket) {
+	{
+		std::scoped_lock lk(mutex);
+		socket = new_socket;
+	}
+
+	if (!new_socket.has_value()) {
+		/*
+			Wait until the chunks already taken by the worker are sent,
+			so that the old socket is never used after this returns.
+		*/
+
+		std::scoped_lock lk(sending_mutex);
+	}
+}
+
+void direct_file_sender::set_rate(const double new_chunks_per_second, const double burst_chunks) {
+	std::scoped_lock lk(mutex);
+
+	chunks_per_second = new_chunks_per_second;
+	max_tokens = std::max(1.0, burst_chunks);
+}
+
+void direct_file_sender::start(
+	const client_id_type client_id,
+	const netcode_address_t address,
+	const augs::secure_hash_type& file_hash,
+	shared_readonly_file file
+) {
+	std::scoped_lock lk(mutex);
+
+	auto& d = downloaders[client_id];
+
+	d.address = address;
+	d.file_hash = file_hash;
+	d.file = std::move(file);
+	d.requested.clear();
+
+	/* A fresh download may presend up to a whole burst. */
+	d.tokens = max_tokens;
+}
+
+void direct_file_sender::request(
+	const client_id_type client_id,
+	const file_chunk_index_type* const indices,
+	const std::size_t n
+) {
+	{
+		std::scoped_lock lk(mutex);
+
+		const auto found = downloaders.find(client_id);
+
+		if (found == downloaders.end()) {
+			return;
+		}
+
+		auto& requested = found->second.requested;
+		const auto max_requested = static_cast<std::size_t>(max_tokens) * 2;
+
+		for (std::size_t i = 0; i < n && requested.size() < max_requested; ++i) {
+			requested.push_back(indices[i]);
+		}
+	}
+
+	wake.notify_one();
+}
+
+void direct_file_sender::stop_all() {
+	std::scoped_lock lk(mutex);
+	downloaders.clear();
+}
+
+void direct_file_sender::take_changed_files(std::vector<augs::secure_hash_type>& out) {
+	std::scoped_lock lk(mutex);
+
+	out = std::move(changed_files);
+	changed_files.clear();
+}
+
+void direct_file_sender::stop_downloads_of_changed_file(const augs::secure_hash_type& file_hash) {
+	std::erase_if(downloaders, [&](const auto& it) {
+		return it.second.file_hash == file_hash;
+	});
+
+	if (std::find(changed_files.begin(), changed_files.end(), file_hash) == changed_files.end()) {
+		changed_files.push_back(file_hash);
+	}
+}
+
+bool direct_file_sender::has_requested_chunks() const {
+	for (const auto& it : downloaders) {
+		if (!it.second.requested.empty()) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void direct_file_sender::refill_tokens(const double dt_secs) {
+	const auto added = dt_secs * chunks_per_second;
+
+	for (auto& it : downloaders) {
+		auto& tokens = it.second.tokens;
+		tokens = std::min(max_tokens, tokens + added);
+	}
+}
+
+void direct_file_sender::take_sendable_chunks(std::vector<queued_chunk>& out) {
+	for (auto& it : downloaders) {
+		auto& d = it.second;
+
+		while (d.tokens >= 1.0 && !d.requested.empty()) {
+			out.push_back({ d.address, d.file_hash, d.file, d.requested.front() });
+
+			d.requested.pop_front();
+			d.tokens -= 1.0;
+		}
+	}
+}
+
+void direct_file_sender::worker_func() {
+	using clock_type = std::chrono::steady_clock;
+
+	std::vector<queued_chunk> sendable;
+	std::vector<augs::secure_hash_type> newly_changed;
+	file_chunk_packet packet;
+
+	auto when_last_refilled = clock_type::now();
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (keep_running) {
+		if (!has_requested_chunks()) {
+			wake.wait(lock, [this]() {
+				return !keep_running || has_requested_chunks();
+			});
+
+			continue;
+		}
+
+		const auto now = clock_type::now();
+		refill_tokens(std::chrono::duration<double>(now - when_last_refilled).count());
+		when_last_refilled = now;
+
+		take_sendable_chunks(sendable);
+
+		if (sendable.empty()) {
+			/* Everyone is out of tokens. Sleep until the next one arrives. */
+			const auto token_interval_secs = chunks_per_second > 0.0 ? 1.0 / chunks_per_second : 0.01;
+
+			wake.wait_for(lock, std::chrono::duration<double>(token_interval_secs));
+			continue;
+		}
+
+		std::scoped_lock sending_lock(sending_mutex);
+
+		auto send_socket = socket;
+
+		/* Reading the file may have to wait for the disk, so never do it under the lock. */
+		lock.unlock();
+
+		if (send_socket.has_value()) {
+			for (auto& chunk : sendable) {
+				const auto result = fill_packet(packet, *chunk.file, chunk.index);
+
+				if (result == fill_result::OK) {
+					packet.file_hash = chunk.file_hash;
+
+					netcode_socket_send_packet(&*send_socket, &chunk.address, reinterpret_cast<void*>(&packet), sizeof(packet));
+				}
+				else if (result == fill_result::FILE_CHANGED) {
+					newly_changed.push_back(chunk.file_hash);
+				}
+			}
+		}
+
+		/* This might drop the last reference to a file and close it. */
+		sendable.clear();
+
+		lock.lock();
+
+		for (const auto& changed : newly_changed) {
+			stop_downloads_of_changed_file(changed);
+		}
+
+		newly_changed.clear();
+	}
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/readwrite/byte_file.h"
+#include "augs/filesystem/file.h"
+#include "all_paths.h"
+
+TEST_CASE("DirectFileSender FileChunks") {
+	const auto path = CACHE_DIR / "test_readonly_file.bin";
+
+	auto chunks_of = [&](const std::size_t file_size) {
+		std::vector<std::byte> bytes(file_size);
+
+		for (std::size_t i = 0; i < file_size; ++i) {
+			bytes[i] = static_cast<std::byte>(i * 31 + 7);
+		}
+
+		augs::bytes_to_file(bytes, path);
+
+		const auto file = augs::readonly_file(path);
+
+		REQUIRE(file.size() == file_size);
+
+		const auto num_chunks = direct_file_sender::calc_num_chunks(file_size);
+
+		std::vector<std::byte> reassembled;
+		file_chunk_packet packet;
+
+		for (std::size_t i = 0; i < num_chunks; ++i) {
+			REQUIRE(direct_file_sender::fill_packet(packet, file, file_chunk_index_type(i)) == direct_file_sender::fill_result::OK);
+
+			const auto n = std::min(file_chunk_size_v, file_size - reassembled.size());
+			reassembled.insert(reassembled.end(), packet.chunk_bytes.begin(), packet.chunk_bytes.begin() + n);
+
+			REQUIRE(std::all_of(packet.chunk_bytes.begin() + n, packet.chunk_bytes.end(), [](const auto b) { return b == std::byte(0); }));
+		}
+
+		REQUIRE(direct_file_sender::fill_packet(packet, file, file_chunk_index_type(num_chunks)) == direct_file_sender::fill_result::INVALID_INDEX);
+		REQUIRE(reassembled == bytes);
+
+		return num_chunks;
+	};
+
+	REQUIRE(chunks_of(0) == 1);
+	REQUIRE(chunks_of(1) == 1);
+	REQUIRE(chunks_of(file_chunk_size_v) == 1);
+	REQUIRE(chunks_of(file_chunk_size_v + 1) == 2);
+	REQUIRE(chunks_of(file_chunk_size_v * 100 + 17) == 101);
+
+#if PLATFORM_UNIX
+	{
+		/* Truncating the file during a download must not crash the sender. */
+		std::vector<std::byte> bytes(file_chunk_size_v * 10, std::byte(1));
+		augs::bytes_to_file(bytes, path);
+
+		const auto file = augs::readonly_file(path);
+		file_chunk_packet packet;
+
+		REQUIRE(direct_file_sender::fill_packet(packet, file, 5) == direct_file_sender::fill_result::OK);
+
+		bytes.resize(file_chunk_size_v * 2);
+		augs::bytes_to_file(bytes, path);
+
+		REQUIRE(file.changed_on_disk());
+		REQUIRE(direct_file_sender::fill_packet(packet, file, 5) == direct_file_sender::fill_result::FILE_CHANGED);
+		REQUIRE(direct_file_sender::fill_packet(packet, file, 0) == direct_file_sender::fill_result::FILE_CHANGED);
+	}
+#endif
+
+	augs::remove_file(path);
+}
+#endif
@@ -0,0 +1,109 @@
+#pragma once
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "augs/misc/secure_hash.h"
+#include "augs/network/network_types.h"
+#include "augs/network/netcode_sockets.h"
+#include "augs/filesystem/readonly_file.h"
+#include "application/setups/server/file_chunk_packet.h"
+
+using shared_readonly_file = std::shared_ptr<const augs::readonly_file>;
+
+/*
+	Sends the chunks of arena files to the clients that download them directly.
+
+	Packets are assembled and sent on a separate thread so that the tick never waits for the disk.
+	The chunks are read straight from the file into the packet.
+
+	If a file changes on disk during a download, its downloads are stopped
+	and its hash is reported through take_changed_files().
+
+	Every downloader has its own token bucket:
+	a chunk is sent only when a token is available,
+	and requests that do not fit in the queue are dropped,
+	since the client will request the missing chunks again anyway.
+*/
+
+class direct_file_sender {
+	struct downloader {
+		netcode_address_t address;
+		augs::secure_hash_type file_hash;
+		shared_readonly_file file;
+
+		std::deque<file_chunk_index_type> requested;
+		double tokens = 0.0;
+	};
+
+	struct queued_chunk {
+		netcode_address_t address;
+		augs::secure_hash_type file_hash;
+		shared_readonly_file file;
+		file_chunk_index_type index;
+	};
+
+	std::mutex mutex;
+	std::mutex sending_mutex;
+	std::condition_variable wake;
+
+	std::unordered_map<client_id_type, downloader> downloaders;
+	std::optional<netcode_socket_t> socket;
+
+	double chunks_per_second = 0.0;
+	double max_tokens = 0.0;
+
+	std::vector<augs::secure_hash_type> changed_files;
+
+	bool keep_running = true;
+	std::thread worker;
+
+	bool has_requested_chunks() const;
+	void refill_tokens(double dt_secs);
+	void take_sendable_chunks(std::vector<queued_chunk>& out);
+	void stop_downloads_of_changed_file(const augs::secure_hash_type&);
+
+	void worker_func();
+
+public:
+	direct_file_sender();
+	~direct_file_sender();
+
+	direct_file_sender(const direct_file_sender&) = delete;
+	direct_file_sender& operator=(const direct_file_sender&) = delete;
+
+	void set_socket(std::optional<netcode_socket_t>);
+
+	/* Applies to every downloader. The bucket holds at most a burst of chunks. */
+	void set_rate(double chunks_per_second, double burst_chunks);
+
+	void start(client_id_type, netcode_address_t, const augs::secure_hash_type&, shared_readonly_file);
+	void request(client_id_type, const file_chunk_index_type* indices, std::size_t n);
+
+	template <class F>
+	void stop_all_except(F&& is_still_downloading) {
+		std::scoped_lock lk(mutex);
+
+		std::erase_if(downloaders, [&](const auto& it) {
+			return !is_still_downloading(it.first);
+		});
+	}
+
+	void stop_all();
+
+	void take_changed_files(std::vector<augs::secure_hash_type>& out);
+
+	enum class fill_result {
+		OK,
+		INVALID_INDEX,
+		FILE_CHANGED
+	};
+
+	static std::size_t calc_num_chunks(std::size_t file_size);
+	static fill_result fill_packet(file_chunk_packet& packet, const augs::readonly_file& file, file_chunk_index_type index);
+};
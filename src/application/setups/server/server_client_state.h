@@ -9,7 +9,7 @@
 
 #include "view/mode_gui/arena/arena_player_meta.h"
 
-using client_pending_entropies = std::vector<total_client_entropy>;
+using client_pending_entropies = augs::jitter_buffer<total_client_entropy>;
 
 enum class downloading_type {
 	NONE,
@@ -52,8 +52,6 @@ struct server_client_state {
 
 	arena_player_meta meta;
 
-	uint32_t direct_file_chunks_left = 0;
-
 	bool auth_requested = false;
 	std::string authenticated_id;
 	bool verified_has_no_ban = false;
@@ -189,7 +189,16 @@ message_handler_result server_setup::handle_payload(
 			c.last_keyboard_activity_time = server_time;
 		}
 
-		c.pending_entropies.emplace_back(std::move(payload));
+		auto& pending = c.pending_entropies;
+		const auto max_commands = vars.max_buffered_client_commands;
+
+		/* Allocates only when the client sends its first command or the limit changes. */
+		pending.set_capacity(max_commands);
+
+		if (!pending.push(std::move(payload))) {
+			kick(client_id, typesafe_sprintf("number of pending commands exceeded the maximum of %x.", max_commands));
+		}
+
 		// LOG("Received %xth command from client. ", c.pending_entropies.size());
 	}
 	else if constexpr (std::is_same_v<T, special_client_request>) {
@@ -349,21 +358,7 @@ message_handler_result server_setup::handle_payload(
 			return continue_v;
 		}
 
-		const auto found_file = mapped_or_nullptr(arena_files_database, *c.now_downloading_file);
-
-		if (found_file == nullptr) {
-			return continue_v;
-		}
-
-		for (const auto chunk_index : payload.requests) {
-			if (c.direct_file_chunks_left == 0) {
-				break;
-			}
-
-			--c.direct_file_chunks_left;
-
-			send_file_chunk(client_id, *found_file, chunk_index);
-		}
+		direct_files.request(client_id, payload.requests.data(), payload.requests.size());
 	}
 	else if constexpr (std::is_same_v<T, ::request_arena_file_download>) {
 		if (!vars.allow_direct_arena_file_downloads) {
@@ -376,19 +371,24 @@ message_handler_result server_setup::handle_payload(
 		};
 
 		if (const auto found_file = mapped_or_nullptr(arena_files_database, payload.requested_file_hash)) {
-			auto& file_bytes = found_file->cached_file;
+			auto& opened_file = found_file->opened_file;
 
-			if (file_bytes.empty()) {
+			if (opened_file == nullptr) {
 				try {
-					file_bytes = augs::file_to_bytes(found_file->path);
+					auto file = std::make_shared<const augs::readonly_file>(found_file->path);
 
 					const auto requested = payload.requested_file_hash;
 
 					if (const bool asking_current_arena = current_arena_hash == requested) {
-						const auto actual = augs::secure_hash(augs::crlf_to_lf_string(file_bytes));
+						/* Hashed block by block so that the whole file is never copied into memory. */
+						auto hash = augs::incremental_secure_hash(true);
 
-						if (const bool current_arena_is_out_of_date = requested != actual) {
-							file_bytes.clear();
+						const bool read_whole = file->for_each_block([&](const std::byte* bytes, const std::size_t n) {
+							hash.update(bytes, n);
+						});
+
+						if (const bool current_arena_is_out_of_date = !read_whole || requested != hash.finalize()) {
+							file.reset();
 
 							broadcast_info("Files changed on the server. Reloading arena.");
 							rechoose_arena();
@@ -396,7 +396,8 @@ message_handler_result server_setup::handle_payload(
 						}
 					}
 
-					if (!file_bytes.empty()) {
+					if (file != nullptr && !file->empty()) {
+						opened_file = std::move(file);
 						opened_arena_files.emplace(payload.requested_file_hash);
 					}
 				}
@@ -406,7 +407,7 @@ message_handler_result server_setup::handle_payload(
 				}
 			}
 
-			if (const bool canceled = file_bytes.empty()) {
+			if (const bool canceled = opened_file == nullptr) {
 				set_client_is_downloading_files(client_id, c, downloading_type::DIRECTLY);
 
 				file_download_payload sent_file_payload;
@@ -425,10 +426,9 @@ message_handler_result server_setup::handle_payload(
 				set_client_is_downloading_files(client_id, c, downloading_type::DIRECTLY);
 				c.when_last_sent_file_packet = get_current_time();
 				c.now_downloading_file = payload.requested_file_hash;
-				c.direct_file_chunks_left = 0;
 
 				file_download_payload sent_file_payload;
-				sent_file_payload.num_file_bytes = file_bytes.size();
+				sent_file_payload.num_file_bytes = opened_file->size();
 
 				server->send_payload(
 					client_id, 
@@ -437,14 +437,31 @@ message_handler_result server_setup::handle_payload(
 					sent_file_payload
 				);
 
-				const auto max_to_presend = uint16_t(calc_num_chunks_per_tick_per_downloader() * 2);
-				const auto num_to_presend = std::min(max_to_presend, payload.num_chunks_to_presend);
-
-				for (file_chunk_index_type chunk_index = 0; chunk_index < num_to_presend; ++chunk_index) {
-					if (!send_file_chunk(client_id, *found_file, chunk_index)) {
-						break;
-					}
+				if (const auto s = find_underlying_socket()) {
+					direct_files.set_socket(*s);
 				}
+
+				/* Account for the new downloader before its bucket is filled. */
+				refresh_available_direct_download_bandwidths();
+
+				direct_files.start(
+					client_id,
+					to_netcode_addr(server->get_client_address(client_id)),
+					payload.requested_file_hash,
+					opened_file
+				);
+
+				const auto max_to_presend = std::min(
+					std::size_t(calc_num_chunks_per_tick_per_downloader()) * 2,
+					direct_file_sender::calc_num_chunks(opened_file->size())
+				);
+
+				const auto num_to_presend = std::min(max_to_presend, std::size_t(payload.num_chunks_to_presend));
+
+				std::vector<file_chunk_index_type> presend_chunks(num_to_presend);
+				std::iota(presend_chunks.begin(), presend_chunks.end(), file_chunk_index_type(0));
+
+				direct_files.request(client_id, presend_chunks.data(), presend_chunks.size());
 			}
 		}
 		else {
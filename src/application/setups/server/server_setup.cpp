@@ -1,3 +1,4 @@
+#include <numeric>
 #include "augs/misc/time_utils.h"
 #include "augs/misc/pool/pool_io.hpp"
 #include "augs/misc/imgui/imgui_scope_wrappers.h"
@@ -199,6 +200,9 @@ void server_setup::send_goodbye_to_masterserver() {
 void server_setup::shutdown() {
 	send_goodbye_to_masterserver();
 
+	direct_files.set_socket(std::nullopt);
+	direct_files.stop_all();
+
 	if (server->is_running()) {
 		LOG("Shutting down the server.");
 		server->stop();
@@ -1539,9 +1543,13 @@ bool server_setup::apply(const server_vars& new_vars, const bool first_time) {
 
 	const bool reload_arena = first_time || vars.arena != new_vars.arena || vars.game_mode != new_vars.game_mode;
 	const bool reload_net_sim = first_time || vars.network_simulator != new_vars.network_simulator;
+	const bool reload_solver_workers = first_time || vars.solver_worker_threads != new_vars.solver_worker_threads;
 
 	vars = new_vars;
 
+	/* The authoritative cosmos restarts rounds from the same clean state over and over. */
+	scene.world.keep_last_set_reinferred(true, std::size_t(vars.max_reinferred_round_state_mb) * 1024 * 1024);
+
 	if (reload_arena) {
 		write_vars_to_disk_once = true;
 
@@ -1578,6 +1586,10 @@ bool server_setup::apply(const server_vars& new_vars, const bool first_time) {
 		server->set(vars.network_simulator);
 	}
 
+	if (reload_solver_workers) {
+		reset_solver_workers();
+	}
+
 	auto broadcast_new_vars_to_rcons = [&](const auto recipient_id, auto&) {
 		const auto rcon_level = get_rcon_level(recipient_id);
 
@@ -1602,6 +1614,35 @@ bool server_setup::apply(const server_vars& new_vars, const bool first_time) {
 	return chosen_next_area;
 }
 
+void server_setup::reset_solver_workers() {
+	/* 
+		Only worth it on dedicated servers. 
+		The integrated server solves during the client's frame which already saturates the thread pool.
+	*/
+
+#if PARALLEL_STANDARD_SOLVER_PHASES
+	if (is_dedicated() && vars.solver_worker_threads > 0) {
+		LOG("Solving independent phases on %x worker threads.", vars.solver_worker_threads);
+		solver_workers = std::make_unique<augs::thread_pool>(vars.solver_worker_threads);
+	}
+	else {
+		solver_workers.reset();
+	}
+#else
+	if (vars.solver_worker_threads > 0) {
+		LOG("solver_worker_threads is ignored: this build solves all phases serially.");
+	}
+
+	solver_workers.reset();
+#endif
+}
+
+solve_settings server_setup::make_solve_settings() const {
+	solve_settings settings;
+	settings.phase_workers = solver_workers.get();
+	return settings;
+}
+
 void server_setup::broadcast_info(const std::string& text, const chat_target_type target) {
 	server_broadcasted_chat message;
 	message.target = target;
@@ -1929,16 +1970,6 @@ void server_setup::advance_clients_state() {
 				kick(client_id, "Account is required to play on this server!");
 			}
 
-			{
-				const auto num_commands = c.pending_entropies.size();
-				const auto max_commands = vars.max_buffered_client_commands;
-
-				if (num_commands > max_commands) {
-					const auto reason = typesafe_sprintf("number of pending commands (%x) exceeded the maximum of %x.", num_commands, max_commands);
-					kick(client_id, reason);
-				}
-			}
-
 			if (!removed_someone_already) {
 				if (c.when_kicked.has_value()) {
 					const auto linger_secs = std::clamp(vars.max_kick_ban_linger_secs, 0.f, 15.f);
@@ -1973,19 +2004,21 @@ void server_setup::advance_clients_state() {
 		}
 
 		auto contribute_to_step_entropy = [&]() {
-#if 0
-			c.pending_entropies.set_lower_limit(
-				c.settings.net.requested_jitter_buffer_ms * inv_simulation_delta_ms;
-			);
-#endif
-
 			const auto jitter_vars = c.settings.net.jitter;
 			const auto jitter_squash_steps = std::max(jitter_vars.buffer_at_least_steps, in_steps(jitter_vars.buffer_at_least_ms));
 
 			auto& inputs = c.pending_entropies;
 
+			/*
+				The client decides how much buffering it wants at the least.
+				If its commands arrive irregularly, we buffer more so that we don't have to extrapolate.
+			*/
+
+			inputs.set_depth_limits(jitter_squash_steps, in_steps(vars.max_jitter_buffer_ms));
+			inputs.begin_step();
+
 			if (const auto num_pending = inputs.size(); num_pending > 0) {
-				const bool should_squash = num_pending >= jitter_squash_steps;
+				const bool should_squash = num_pending >= inputs.get_target_depth();
 
 				total_client_entropy entropy;
 
@@ -2002,18 +2035,17 @@ void server_setup::advance_clients_state() {
 							entropy += inputs[i];
 						}
 
-						if (num_squashed == num_pending) {
-							inputs.clear();
-						}
-						else {
-							erase_first_n(inputs, num_squashed);
+						inputs.pop_front(num_squashed);
+
+						if (num_squashed > 1) {
+							inputs.note_catch_up();
 						}
 
 						return static_cast<uint8_t>(num_squashed);
 					}
 
-					entropy = inputs[0];
-					erase_first_n(inputs, 1);
+					entropy = std::move(inputs[0]);
+					inputs.pop_front(1);
 
 					return static_cast<uint8_t>(1);
 				}();
@@ -2641,55 +2673,46 @@ void server_setup::clean_unused_cached_files() {
 	);
 }
 
-bool server_setup::send_file_chunk(const client_id_type client_id, const arena_files_database_entry& entry, const file_chunk_index_type chunk_index) {
-	const auto& c = clients[client_id];
+void server_setup::handle_changed_arena_files() {
+	thread_local std::vector<augs::secure_hash_type> changed;
+	direct_files.take_changed_files(changed);
 
-	const auto& bytes = entry.cached_file;
-	const auto bytes_n = bytes.size();
-
-	auto num_all_chunks = bytes_n / file_chunk_size_v;
-
-	if (bytes_n % file_chunk_size_v != 0) {
-		++num_all_chunks;
-	}
-
-	if (bytes_n == 0) {
-		num_all_chunks = 1;
+	if (changed.empty()) {
+		return;
 	}
 
-	file_chunk_packet packet;
-	packet.index = chunk_index;
-	packet.file_hash = *c.now_downloading_file;
-
-	const auto last_chunk_index = num_all_chunks - 1;
-
-	if (chunk_index <= last_chunk_index) {
-		const bool is_last_chunk = chunk_index == last_chunk_index;
-
-		const auto bytes_start = 							std::size_t(chunk_index) * file_chunk_size_v;
-		const auto bytes_end   = is_last_chunk ? bytes_n : (std::size_t(bytes_start) + file_chunk_size_v);
-
-		ensure(bytes_end <= bytes_n);
+	for (const auto& hash : changed) {
+		if (const auto found = mapped_or_nullptr(arena_files_database, hash)) {
+			LOG("%x changed on disk during a download.", found->path);
+			found->free_opened_file();
+		}
 
-		const auto bytes_copied = bytes_end - bytes_start;
+		opened_arena_files.erase(hash);
+	}
 
-		if (bytes_copied != 0) {
-			std::memcpy(packet.chunk_bytes.data(), bytes.data() + bytes_start, bytes_copied);
+	/* Cancel the downloads just like when the file is found out of date upon request. */
+	for_each_id_and_client([&](const auto client_id, auto& c) {
+		if (!c.now_downloading_file.has_value() || !found_in(changed, *c.now_downloading_file)) {
+			return;
 		}
 
-		if (auto s = find_underlying_socket()) {
-			auto address = to_netcode_addr(server->get_client_address(client_id));
+		c.now_downloading_file = std::nullopt;
+		c.lingering_after_arena_reloaded = true;
 
-			const auto num_packet_bytes = sizeof(packet);
-			// LOG("sending chunk %x to %x (%x bytes). CMD: %x", chunk_index, ::ToString(address), num_packet_bytes, packet.command);
-			auto socket = *s;
-			netcode_socket_send_packet(&socket, &address, reinterpret_cast<void*>(&packet), num_packet_bytes);
+		file_download_payload sent_file_payload;
+		sent_file_payload.num_file_bytes = 0;
 
-			return true;
-		}
-	}
+		server->send_payload(
+			client_id, 
+			game_channel_type::RELIABLE_MESSAGES, 
 
-	return false;
+			sent_file_payload
+		);
+	}, only_connected_v);
+
+	broadcast_info("Files changed on the server. Reloading arena.");
+	rechoose_arena();
+	rebroadcast_server_public_vars();
 }
 
 file_chunk_index_type server_setup::calc_num_chunks_per_tick_per_downloader() const {
@@ -2718,16 +2741,22 @@ file_chunk_index_type server_setup::calc_num_chunks_per_tick_per_downloader() co
 void server_setup::refresh_available_direct_download_bandwidths() {
 	const auto num_chunks = calc_num_chunks_per_tick_per_downloader();
 
-	auto refresh_chunks = [&](const auto, auto& c) {
-		if (c.downloading_status == downloading_type::DIRECTLY) {
-			c.direct_file_chunks_left = num_chunks;
-		}
-		else {
-			c.direct_file_chunks_left = 0;
+	/* Same budget as before, only spread evenly over the tick instead of sent in a burst. */
+	direct_files.set_rate(num_chunks / get_inv_tickrate(), num_chunks * 2);
+
+	std::array<bool, max_incoming_connections_v> downloading_directly = {};
+
+	auto gather_downloaders = [&](const client_id_type client_id, auto& c) {
+		if (c.downloading_status == downloading_type::DIRECTLY && c.now_downloading_file.has_value()) {
+			downloading_directly[client_id] = true;
 		}
 	};
 
-	for_each_id_and_client(refresh_chunks, connected_and_integrated_v);
+	for_each_id_and_client(gather_downloaders, only_connected_v);
+
+	direct_files.stop_all_except([&](const client_id_type client_id) {
+		return downloading_directly[client_id];
+	});
 }
 
 void server_setup::send_packets_if_its_time() {
@@ -2848,6 +2877,10 @@ bool server_setup::should_have_admin_character() const {
 	return is_integrated();
 }
 
+double server_setup::get_secs_until_next_tick() const {
+	return server_time - get_current_time();
+}
+
 void server_setup::sleep_until_next_tick() {
 	const auto sleep_mult = std::clamp(vars.sleep_mult, 0.f, 0.9f);
 
@@ -2855,7 +2888,7 @@ void server_setup::sleep_until_next_tick() {
 		return;
 	}
 
-	const auto sleep_dt = static_cast<float>(server_time - get_current_time());
+	const auto sleep_dt = static_cast<float>(get_secs_until_next_tick());
 	const auto to_sleep_ms = sleep_dt * sleep_mult;
 
 	if (sleep_dt > 0.0) {
@@ -3280,6 +3313,78 @@ void server_setup::log_performance() {
 	}
 }
 
+void server_setup::write_jitter_buffer_metrics(std::string& output, const std::string& prefix, const std::string& labels) const {
+	auto write_per_client = [&](const auto& suffix, const auto& type, auto get_value) {
+		const auto name = typesafe_sprintf("%x%x", prefix, suffix);
+
+		output += typesafe_sprintf("# TYPE %x %x\n", name, type);
+
+		for_each_id_and_client([&](const auto client_id, const auto& c) {
+			if (c.state != client_state_type::IN_GAME) {
+				return;
+			}
+
+			const auto stats = c.pending_entropies.get_stats();
+			const auto client_labels = server_profiler::metric_labels(labels, typesafe_sprintf("client=\"%x\"", int(client_id)));
+			output += typesafe_sprintf("%x%x %x\n", name, client_labels, get_value(stats));
+		}, only_connected_v);
+	};
+
+	write_per_client("occupancy", "gauge", [](const auto& s) { return s.occupancy; });
+	write_per_client("target_depth", "gauge", [](const auto& s) { return s.target_depth; });
+	write_per_client("jitter_steps", "gauge", [](const auto& s) { return s.jitter_steps; });
+	write_per_client("steps_extrapolated_total", "counter", [](const auto& s) { return s.steps_extrapolated; });
+	write_per_client("catch_ups_total", "counter", [](const auto& s) { return s.catch_ups; });
+	write_per_client("overflows_total", "counter", [](const auto& s) { return s.overflows; });
+}
+
+void server_setup::write_performance_metrics_if_its_time() {
+	if (!is_dedicated()) {
+		return;
+	}
+
+	const auto& path = private_vars.performance_metrics_path;
+
+	if (path.empty()) {
+		return;
+	}
+
+	const auto once_every = std::max(private_vars.write_performance_metrics_once_every_secs, 1.0f);
+
+	if (server_time - last_wrote_metrics_at < once_every) {
+		return;
+	}
+
+	last_wrote_metrics_at = server_time;
+
+	auto& cosmic = scene.world.profiler;
+
+	/* A single process might host several arenas, each at its own port. */
+	const auto labels = typesafe_sprintf("arena=\"%x\"", last_start.port);
+
+	std::string metrics;
+	profiler.write_metrics(metrics, "hypersomnia_server_", labels);
+	cosmic.write_metrics(metrics, "hypersomnia_cosmos_", labels);
+
+	profiler.clear_histograms();
+	cosmic.clear_histograms();
+
+	write_jitter_buffer_metrics(metrics, "hypersomnia_server_client_jitter_buffer_", labels);
+
+	/* Scrapers should never see a half-written file. */
+	const auto target_path = augs::path_type(path);
+	auto temporary_path = target_path;
+	temporary_path += ".tmp";
+
+	try {
+		augs::save_as_text(temporary_path, metrics);
+		std::filesystem::rename(temporary_path, target_path);
+	}
+	catch (const std::exception& err) {
+		LOG("Failed to write performance metrics to %x: %x", path, err.what());
+	}
+}
+
 bool server_setup::requires_cursor() const {
 	return arena_gui_base::requires_cursor() || integrated_client_gui.requires_cursor();
 }
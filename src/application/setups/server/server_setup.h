@@ -35,8 +35,10 @@
 #include "application/setups/server/rcon_level.h"
 #include "game/messages/mode_notification.h"
 #include "application/setups/server/file_chunk_packet.h"
+#include "application/setups/server/direct_file_sender.h"
 #include "application/arena/synced_dynamic_vars.h"
 #include "steam_rich_presence_pairs.h"
+#include "augs/templates/thread_pool.h"
 
 struct netcode_socket_t;
 struct config_lua_table;
@@ -61,10 +63,11 @@ struct editor_project;
 
 struct arena_files_database_entry {
 	augs::path_type path;
-	std::vector<std::byte> cached_file;
+	shared_readonly_file opened_file;
 
 	void free_opened_file() {
-		std::vector<std::byte>().swap(cached_file);
+		/* Downloaders still in progress keep their own reference. */
+		opened_file.reset();
 	}
 };
 
@@ -145,6 +148,8 @@ class server_setup :
 	bool reinference_necessary = false;
 
 	augs::propagate_const<std::unique_ptr<server_adapter>> server;
+	direct_file_sender direct_files;
+	std::unique_ptr<augs::thread_pool> solver_workers;
 	std::array<server_client_state, max_incoming_connections_v> clients;
 	uint32_t next_session_id = 0;
 
@@ -241,6 +246,7 @@ class server_setup :
 
 public:
 	net_time_t last_logged_at = 0;
+	net_time_t last_wrote_metrics_at = 0;
 	server_profiler profiler;
 
 	bool should_check_for_updates_once();
@@ -276,6 +282,9 @@ private:
 	void refresh_available_direct_download_bandwidths();
 	void send_packets_if_its_time();
 
+	void reset_solver_workers();
+	solve_settings make_solve_settings() const;
+
 	void send_tell_me_my_address();
 	void send_tell_me_my_address_if_its_time();
 
@@ -527,7 +536,7 @@ public:
 					arena.advance(
 						unpacked, 
 						new_callbacks, 
-						solve_settings()
+						make_solve_settings()
 					);
 				}
 				else {
@@ -557,7 +566,7 @@ public:
 					arena.advance(
 						unpacked, 
 						new_callbacks, 
-						solve_settings()
+						make_solve_settings()
 					);
 
 					const auto& removed = unpacked.general.removed_player;
@@ -576,9 +585,11 @@ public:
 		}
 
 		refresh_available_direct_download_bandwidths();
+		handle_changed_arena_files();
 		clean_unused_cached_files();
 
 		log_performance();
+		write_performance_metrics_if_its_time();
 	}
 
 	template <class T>
@@ -617,6 +628,7 @@ public:
 	bool is_running() const;
 	bool should_have_admin_character() const;
 
+	double get_secs_until_next_tick() const;
 	void sleep_until_next_tick();
 
 	void update_stats(server_network_info&) const;
@@ -679,6 +691,8 @@ public:
 
 	void reset_player_meta_to_default(const mode_player_id&);
 	void log_performance();
+	void write_performance_metrics_if_its_time();
+	void write_jitter_buffer_metrics(std::string& output, const std::string& prefix, const std::string& labels) const;
 
 	::synced_meta_update make_synced_meta_update_from(
 		const server_client_state&,
@@ -732,8 +746,8 @@ public:
 
 	file_chunk_index_type calc_num_chunks_per_tick_per_downloader() const;
 
-	bool send_file_chunk(client_id_type id, const arena_files_database_entry& entry, file_chunk_index_type i);
 	void clean_unused_cached_files();
+	void handle_changed_arena_files();
 
 	void apply_nonzoomedout_visible_world_area(vec2);
 
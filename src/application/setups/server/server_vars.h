@@ -134,6 +134,7 @@ struct server_vars {
 	uint32_t send_packets_once_every_tick = 1;
 
 	uint32_t max_buffered_client_commands = 1000;
+	uint32_t max_jitter_buffer_ms = 150;
 
 	uint32_t state_hash_once_every_tick = 1;
 	float send_net_statistics_update_once_every_secs = 1;
@@ -146,6 +147,8 @@ struct server_vars {
 	bool auto_authorize_internal_for_rcon = false;
 	uint32_t max_unauthorized_rcon_commands = 100;
 	uint32_t max_bots = 0;
+	uint32_t solver_worker_threads = 0;
+	uint32_t max_reinferred_round_state_mb = 256;
 	float log_performance_once_every_secs = 1;
 	float sleep_mult = 0.1f;
 
@@ -181,5 +184,8 @@ struct server_private_vars {
 	std::string report_ranked_match_api_key = "";
 	std::string report_ranked_match_url = "https://hypersomnia.xyz/report_match";
 	std::string check_ban_endpoint = "https://hypersomnia.xyz/check_ban";
+
+	std::string performance_metrics_path = "";
+	float write_performance_metrics_once_every_secs = 10;
 	// END GEN INTROSPECTOR
 };
@@ -167,6 +167,13 @@ namespace augs {
 
 			std::visit(command_handler, cmd.payload);
 		}
+
+		/* Streamed sounds are decoded here, on the audio thread, a chunk at a time. */
+		flash_noise_source.update_stream();
+
+		for (auto& s : source_pool) {
+			s.update_stream();
+		}
 #else
 		(void)c;
 		(void)n;
@@ -0,0 +1,287 @@
+#include "augs/audio/audio_command_buffers.h"
+#include "augs/templates/remove_cref.h"
+
+namespace augs {
+	template <class T>
+	static void store_max(std::atomic<T>& target, const T value) {
+		auto current = target.load(std::memory_order_relaxed);
+
+		while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+	}
+
+	std::size_t audio_command_coalescer::coalesce(audio_command_buffer& cmds) {
+		overwritten.fill(0);
+		redundant.assign(cmds.size(), 0);
+
+		bool listener_overwritten = false;
+		std::size_t num_redundant = 0;
+
+		/* Walk backwards, so that we know which properties are set again later. */
+
+		for (std::size_t i = cmds.size(); i-- > 0;) {
+			auto is_redundant = [&](const auto& t) {
+				using C = remove_cref<decltype(t)>;
+
+				if constexpr(std::is_same_v<C, update_listener_properties>) {
+					const bool result = listener_overwritten;
+					listener_overwritten = true;
+					return result;
+				}
+				else if constexpr(std::is_same_v<C, update_flash_noise>) {
+					return false;
+				}
+				else {
+					if (t.proxy_id < 0 || static_cast<std::size_t>(t.proxy_id) >= overwritten.size()) {
+						return false;
+					}
+
+					auto& flags = overwritten[t.proxy_id];
+
+					if constexpr(std::is_same_v<C, update_multiple_properties>) {
+						/* Velocity is set only on request, so a later update might leave it as it was. */
+						const bool result = (flags & PROPERTIES) && (!t.set_velocity || (flags & PROPERTIES_WITH_VELOCITY));
+
+						flags |= PROPERTIES;
+
+						if (t.set_velocity) {
+							flags |= PROPERTIES_WITH_VELOCITY;
+						}
+
+						return result;
+					}
+					else if constexpr(std::is_same_v<C, source1f_command>) {
+						const uint8_t bit = t.type == source1f_command_type::GAIN ? GAIN : PITCH;
+						const bool result = (flags & (bit | PROPERTIES)) != 0;
+
+						flags |= bit;
+						return result;
+					}
+					else {
+						/* Playing, stopping, binding or seeking should see the properties that were set before. */
+						flags = 0;
+						return false;
+					}
+				}
+			};
+
+			if (std::visit(is_redundant, cmds[i].payload)) {
+				redundant[i] = 1;
+				++num_redundant;
+			}
+		}
+
+		if (num_redundant > 0) {
+			std::size_t num_kept = 0;
+
+			for (std::size_t i = 0; i < cmds.size(); ++i) {
+				if (!redundant[i]) {
+					if (num_kept != i) {
+						cmds[num_kept] = std::move(cmds[i]);
+					}
+
+					++num_kept;
+				}
+			}
+
+			cmds.erase(cmds.begin() + num_kept, cmds.end());
+		}
+
+		return num_redundant;
+	}
+
+	audio_command_buffers::audio_command_buffers() {
+		audio_thread.emplace([this]() { worker_func(); });
+	}
+
+	void audio_command_buffers::quit() {
+		should_quit.store(true, std::memory_order_release);
+		audio_thread->join();
+		stop_all_sources();
+	}
+
+	audio_command_buffer* audio_command_buffers::map_write_buffer() {
+		const auto w = write_count.load(std::memory_order_relaxed);
+
+		if (w - read_count.load(std::memory_order_acquire) >= slots.size()) {
+			return nullptr;
+		}
+
+		return std::addressof(slots[w % slots.size()].commands);
+	}
+
+	void audio_command_buffers::submit_write_buffer() {
+		const auto w = write_count.load(std::memory_order_relaxed);
+
+		if (w - read_count.load(std::memory_order_acquire) >= slots.size()) {
+			return;
+		}
+
+		auto& s = slots[w % slots.size()];
+
+		if (s.commands.empty()) {
+			return;
+		}
+
+		s.when_submitted = clock_type::now();
+		write_count.store(w + 1, std::memory_order_release);
+	}
+
+	void audio_command_buffers::finish() {
+		const auto w = write_count.load(std::memory_order_relaxed);
+
+		while (read_count.load(std::memory_order_acquire) != w) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	audio_command_stats audio_command_buffers::take_stats() {
+		audio_command_stats stats;
+
+		stats.max_queue_depth = max_queue_depth.exchange(0, std::memory_order_relaxed);
+		stats.num_coalesced = num_coalesced.exchange(0, std::memory_order_relaxed);
+		stats.num_performed_batches = num_performed_batches.exchange(0, std::memory_order_relaxed);
+		stats.max_latency_secs = max_latency_ns.exchange(0, std::memory_order_relaxed) / 1e9;
+
+		return stats;
+	}
+
+	void audio_command_buffers::perform_queued() {
+		const auto first = read_count.load(std::memory_order_relaxed);
+		const auto last = write_count.load(std::memory_order_acquire);
+		const auto depth = last - first;
+
+		store_max(max_queue_depth, depth);
+
+		merged.clear();
+
+		for (auto i = first; i != last; ++i) {
+			const auto& cmds = slots[i % slots.size()].commands;
+			merged.insert(merged.end(), cmds.begin(), cmds.end());
+		}
+
+		if (!merged.empty()) {
+			num_coalesced.fetch_add(coalescer.coalesce(merged), std::memory_order_relaxed);
+		}
+
+		{
+			/* Even with nothing queued, streamed sounds need their next chunks. */
+			std::scoped_lock lk(backend_mutex);
+			backend.perform(merged.data(), merged.size());
+		}
+
+		if (depth == 0) {
+			return;
+		}
+
+		const auto now = clock_type::now();
+
+		for (auto i = first; i != last; ++i) {
+			auto& s = slots[i % slots.size()];
+
+			const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - s.when_submitted).count();
+			store_max(max_latency_ns, static_cast<int64_t>(latency));
+
+			s.commands.clear();
+		}
+
+		num_performed_batches.fetch_add(depth, std::memory_order_relaxed);
+		read_count.store(last, std::memory_order_release);
+	}
+
+	void audio_command_buffers::worker_func() {
+		const auto interval = std::chrono::milliseconds(audio_update_interval_ms_v);
+		auto next_update = clock_type::now();
+
+		while (!should_quit.load(std::memory_order_acquire)) {
+			perform_queued();
+
+			next_update += interval;
+
+			/* If we fell behind, do not try to catch up with a burst of updates. */
+			next_update = std::max(next_update, clock_type::now());
+
+			std::this_thread::sleep_until(next_update);
+		}
+
+		perform_queued();
+	}
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("AudioCommands Coalescing") {
+	using namespace augs;
+
+	auto props = [](const int id, const float gain, const bool set_velocity = false) {
+		update_multiple_properties cmd;
+		cmd.proxy_id = id;
+		cmd.gain = gain;
+		cmd.set_velocity = set_velocity;
+		return audio_command { cmd };
+	};
+
+	auto gain = [](const int id, const float v) {
+		return audio_command { source1f_command { id, source1f_command_type::GAIN, v } };
+	};
+
+	auto play = [](const int id) {
+		return audio_command { source_no_arg_command { id, source_no_arg_command_type::PLAY } };
+	};
+
+	auto listener = []() {
+		return audio_command { update_listener_properties() };
+	};
+
+	auto gain_of = [](const audio_command& c) {
+		return std::get<update_multiple_properties>(c.payload).gain;
+	};
+
+	auto coalescer = std::make_unique<audio_command_coalescer>();
+
+	{
+		audio_command_buffer cmds = {
+			listener(),
+			props(0, 0.1f),
+			gain(0, 0.5f),
+			props(1, 0.2f),
+			listener(),
+			props(0, 0.3f),
+			props(1, 0.4f)
+		};
+
+		REQUIRE(coalescer->coalesce(cmds) == 4);
+		REQUIRE(cmds.size() == 3);
+		REQUIRE(std::holds_alternative<update_listener_properties>(cmds[0].payload));
+		REQUIRE(gain_of(cmds[1]) == 0.3f);
+		REQUIRE(gain_of(cmds[2]) == 0.4f);
+	}
+
+	{
+		/* Properties set before playing must stay. */
+		audio_command_buffer cmds = {
+			props(0, 0.1f),
+			play(0),
+			props(0, 0.2f)
+		};
+
+		REQUIRE(coalescer->coalesce(cmds) == 0);
+		REQUIRE(cmds.size() == 3);
+	}
+
+	{
+		/* A later update that does not set the velocity cannot replace one that does. */
+		audio_command_buffer cmds = {
+			props(0, 0.1f, true),
+			props(0, 0.2f),
+			props(0, 0.3f, true),
+			props(0, 0.4f)
+		};
+
+		REQUIRE(coalescer->coalesce(cmds) == 2);
+		REQUIRE(cmds.size() == 2);
+		REQUIRE(gain_of(cmds[0]) == 0.3f);
+		REQUIRE(gain_of(cmds[1]) == 0.4f);
+	}
+}
+#endif
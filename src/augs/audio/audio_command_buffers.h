@@ -1,164 +1,119 @@
 #pragma once
-#include <vector>
-#include <atomic>
+#include <array>
 #include <mutex>
-#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <optional>
 
-#include "augs/templates/thread_pool.h"
 #include "augs/audio/audio_command.h"
 #include "augs/audio/audio_backend.h"
+#include "augs/audio/sound_sizes.h"
 
-static constexpr int num_audio_buffers_v = 2;
+static constexpr int num_audio_buffers_v = 8;
+static constexpr int audio_update_interval_ms_v = 5;
 
 namespace augs {
-	class audio_command_buffers {
-		thread_pool& pool_to_help;
-		audio_backend backend;
-		std::optional<std::thread> audio_thread;
-
-		std::condition_variable for_new_buffers;
-		std::condition_variable for_completion;
-		std::mutex queue_mutex;
-
-		bool should_quit = false;
-		int read_index = 0;
-		int write_index = 0;
+	struct audio_command_stats {
+		std::size_t max_queue_depth = 0;
+		std::size_t num_coalesced = 0;
+		std::size_t num_performed_batches = 0;
+		double max_latency_secs = 0.0;
+	};
 
-		std::array<audio_command_buffer, num_audio_buffers_v> buffers;
+	/*
+		Drops the property updates that are overwritten by a later command for the same source,
+		e.g. when several frames were queued before the audio thread got to them.
+	*/
 
-		int next_to(const int idx) const {
-			if (idx == num_audio_buffers_v - 1) {
-				return 0;
-			}
+	class audio_command_coalescer {
+		enum overwritten_flags : uint8_t {
+			PROPERTIES = 1 << 0,
+			PROPERTIES_WITH_VELOCITY = 1 << 1,
+			GAIN = 1 << 2,
+			PITCH = 1 << 3
+		};
 
-			return idx + 1;
-		}
+		std::array<uint8_t, SOUNDS_SOURCES_IN_POOL> overwritten;
+		std::vector<uint8_t> redundant;
 
-		int prev_to(const int idx) const {
-			if (idx == 0) {
-				return num_audio_buffers_v - 1;
-			}
-
-			return idx - 1;
-		}
+	public:
+		/* Returns the number of dropped commands. */
+		std::size_t coalesce(audio_command_buffer&);
+	};
 
-		auto lock_queue() {
-			return std::unique_lock<std::mutex>(queue_mutex);
-		}
+	/*
+		Commands are recorded on the frame side and performed on a dedicated audio thread.
 
-		auto make_worker_lambda() {
-			return [this]() {
-				for (;;) {
-					const augs::audio_command_buffer* cmds; 
+		The slots form a single-producer/single-consumer ring,
+		so neither side ever waits for the other to submit or consume.
+		If the ring is full, the frame simply renders no sound commands.
 
-					{
-						auto lk = lock_queue();
-						for_new_buffers.wait(lk, [&]{ return should_quit || has_tasks(); });
+		The audio thread wakes at a fixed rate regardless of the framerate,
+		so that streamed sounds keep being decoded even if rendering stalls.
+		It performs everything that was queued since its last update at once.
+	*/
 
-						if (should_quit && !has_tasks()) {
-							return;
-						}
+	class audio_command_buffers {
+		using clock_type = std::chrono::steady_clock;
 
-						cmds = std::addressof(get_read_buffer());
-					}
+		struct slot {
+			audio_command_buffer commands;
+			clock_type::time_point when_submitted;
+		};
 
-					backend.perform(
-						cmds->data(),
-						cmds->size()
-					);
+		std::array<slot, num_audio_buffers_v> slots;
 
-					report_completion();
-				}
-			};
-		}
+		/* Only ever increasing. The slot index is the counter modulo the ring size. */
+		std::atomic<std::size_t> read_count = 0;
+		std::atomic<std::size_t> write_count = 0;
 
-		void report_completion() {
-			auto lk = lock_queue();
-			read_index = next_to(read_index);
+		std::atomic<bool> should_quit = false;
 
-			if (has_finished()) {
-				for_completion.notify_all();
-				pool_to_help.help_until_no_tasks();
-			}
-		}
+		std::atomic<std::size_t> max_queue_depth = 0;
+		std::atomic<std::size_t> num_coalesced = 0;
+		std::atomic<std::size_t> num_performed_batches = 0;
+		std::atomic<int64_t> max_latency_ns = 0;
 
-		bool is_full() const {
-			return write_index == prev_to(read_index);
-		}
+		/* Guards the backend against stop_sources_if called from the main thread. */
+		std::mutex backend_mutex;
+		audio_backend backend;
 
-		bool has_finished() const {
-			return read_index == write_index;
-		}
+		audio_command_buffer merged;
+		audio_command_coalescer coalescer;
 
-		bool has_tasks() const {
-			return !has_finished();
-		}
+		std::optional<std::thread> audio_thread;
 
-		const audio_command_buffer& get_read_buffer() const {
-			return buffers[read_index];
-		}
+		void worker_func();
+		void perform_queued();
 
 		audio_command_buffers(audio_command_buffers&&) = delete;
 		audio_command_buffers(const audio_command_buffers&) = delete;
 
 		audio_command_buffers& operator=(audio_command_buffers&&) = delete;
 		audio_command_buffers& operator=(const audio_command_buffers&) = delete;
-		
-		void request_quit() {
-			{
-				auto lk = lock_queue();
-				should_quit = true;
-			}
-
-			for_new_buffers.notify_all();
-		}
 
 	public:
-		audio_command_buffers(thread_pool& pool_to_help) : pool_to_help(pool_to_help) {
-			audio_thread.emplace(make_worker_lambda());
-		}
+		audio_command_buffers();
 
-		void quit() {
-			request_quit();
-			audio_thread->join(); 
-			stop_all_sources();
-		}
+		void quit();
 
-		audio_command_buffer* map_write_buffer() {
-			auto lk = lock_queue();
+		audio_command_buffer* map_write_buffer();
+		void submit_write_buffer();
 
-			if (is_full()) {
-				return nullptr;
-			}
+		/* Waits until the audio thread performs every submitted command. */
+		void finish();
 
-			return buffers.data() + write_index;
-		}
-
-		auto submit_write_buffer() {
-			auto lk = lock_queue();
-
-			if (buffers[write_index].empty()) {
-				return;
-			}
-
-			write_index = next_to(write_index);
-			buffers[write_index].clear();
-
-			for_new_buffers.notify_all();
-		}
-
-		void finish() {
-			auto lk = lock_queue();
-			for_completion.wait(lk, [&]() { return has_finished(); });
-		}
+		audio_command_stats take_stats();
 
 		template <class F>
 		void stop_sources_if(F&& pred) {
+			std::scoped_lock lk(backend_mutex);
 			backend.stop_sources_if(std::forward<F>(pred));
 		}
 
 		void stop_all_sources() {
-			backend.stop_sources_if([&](auto&&...) { return true; });
+			stop_sources_if([&](auto&&...) { return true; });
 		}
 	};
 }
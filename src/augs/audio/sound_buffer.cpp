@@ -11,6 +11,7 @@
 #include "augs/filesystem/file.h"
 
 #include "augs/audio/sound_data.h"
+#include "augs/audio/sound_stream.h"
 #include "augs/audio/sound_buffer.h"
 
 #include "augs/string/string_templates.h"
@@ -48,6 +49,13 @@ namespace augs {
 
 	single_sound_buffer::single_sound_buffer(const sound_data& data) : single_sound_buffer(data, sound_buffer_loading_settings()) {}
 
+	single_sound_buffer::single_sound_buffer(const sound_stream& stream, const path_type& streamed_path) :
+		streamed_path(streamed_path)
+	{
+		generate_id();
+		meta.computed_length_in_seconds = stream.get_length_in_seconds();
+	}
+
 	single_sound_buffer::~single_sound_buffer() {
 		destroy();
 	}
@@ -55,10 +63,12 @@ namespace augs {
 	single_sound_buffer::single_sound_buffer(single_sound_buffer&& b) : 
 		meta(std::move(b.meta)),
 		id(b.id),
-		initialized(b.initialized)
+		initialized(b.initialized),
+		streamed_path(std::move(b.streamed_path))
 	{
 		b.initialized = false;
 		b.meta = {};
+		b.streamed_path.clear();
 	}
 
 	single_sound_buffer& single_sound_buffer::operator=(single_sound_buffer&& b) {
@@ -67,9 +77,11 @@ namespace augs {
 		meta = std::move(b.meta);
 		id = b.id;
 		initialized = b.initialized;
+		streamed_path = std::move(b.streamed_path);
 
 		b.initialized = false;
 		b.meta = {};
+		b.streamed_path.clear();
 
 		return *this;
 	}
@@ -93,7 +105,7 @@ namespace augs {
 		return get_id();
 	}
 
-	void single_sound_buffer::set_data(const sound_data& new_data) {
+	void single_sound_buffer::generate_id() {
 		if (!initialized) {
 			AL_CHECK(alGenBuffers(1, &id));
 
@@ -103,6 +115,10 @@ namespace augs {
 #endif
 			initialized = true;
 		}
+	}
+
+	void single_sound_buffer::set_data(const sound_data& new_data) {
+		generate_id();
 
 		if (new_data.samples.empty()) {
 			LOG("WARNING! No samples were sent to a sound buffer.");
@@ -113,6 +129,7 @@ namespace augs {
 		const auto passed_frequency = new_data.frequency;
 		const auto passed_bytesize = new_data.samples.size() * sizeof(sound_sample_type);
 		meta.computed_length_in_seconds = new_data.compute_length_in_seconds();
+		meta.resident_bytes = passed_bytesize;
 
 #if LOG_AUDIO_BUFFERS
 		LOG("Passed format: %x\nPassed frequency: %x\nPassed bytesize: %x", passed_format, passed_frequency, passed_bytesize);
@@ -134,7 +151,21 @@ namespace augs {
 
 	void sound_buffer::from_file(const sound_buffer_loading_input input) {
 		const auto& path = input.source_sound;
-		variations.emplace_back(path, input.settings);
+
+		auto add_variation = [&](const path_type& variation_path) {
+			if (input.stream_if_longer_than_secs > 0.0 && can_be_streamed(variation_path)) {
+				const auto stream = sound_stream(variation_path);
+
+				if (stream.get_length_in_seconds() > input.stream_if_longer_than_secs) {
+					variations.emplace_back(stream, variation_path);
+					return;
+				}
+			}
+
+			variations.emplace_back(sound_data(variation_path), input.settings);
+		};
+
+		add_variation(path);
 
 		const auto ext = augs::path_type(path).extension();
 		const auto without_ext = augs::path_type(path).replace_extension("").string();
@@ -146,7 +177,7 @@ namespace augs {
 				const auto next_path = augs::path_type(typesafe_sprintf("%x_%x%x", without_num, i, ext));
 
 				try {
-					variations.emplace_back(next_path, input.settings);
+					add_variation(next_path);
 				}
 				catch (...) {
 					break;
@@ -155,6 +186,16 @@ namespace augs {
 		}
 	}
 
+	std::size_t sound_buffer::get_resident_bytes() const {
+		std::size_t total = 0;
+
+		for (const auto& v : variations) {
+			total += v.get_meta().resident_bytes;
+		}
+
+		return total;
+	}
+
 	const single_sound_buffer& sound_buffer::get_buffer(const std::size_t variation_index) const {
 		const auto chosen_variation = variation_index % variations.size();
 		return variations[chosen_variation];
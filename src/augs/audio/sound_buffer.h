@@ -9,6 +9,7 @@ using ALenum = int;
 
 namespace augs {
 	struct sound_data;
+	class sound_stream;
 
 	ALenum get_openal_format_of(const sound_data&);
 
@@ -16,13 +17,22 @@ namespace augs {
 		sound_buffer_meta meta;
 		ALuint id = 0;
 		bool initialized = false;
+
+		/* 
+			Empty for sounds that are fully resident. 
+			A streamed sound still generates an empty buffer so that its id can identify the sources playing it.
+		*/
+
+		path_type streamed_path;
 		
+		void generate_id();
 		void set_data(const sound_data&);
 		void destroy();
 
 	public:
 		single_sound_buffer(const sound_data&);
 		single_sound_buffer(const sound_data&, sound_buffer_loading_settings);
+		single_sound_buffer(const sound_stream&, const path_type& streamed_path);
 
 		~single_sound_buffer();
 
@@ -40,6 +50,14 @@ namespace augs {
 		const auto& get_meta() const {
 			return meta;
 		}
+
+		bool is_streamed() const {
+			return !streamed_path.empty();
+		}
+
+		const auto& get_streamed_path() const {
+			return streamed_path;
+		}
 	};
 
 	class sound_buffer {
@@ -51,8 +69,10 @@ namespace augs {
 
 		const single_sound_buffer& get_buffer(std::size_t variation_index) const;
 
-		const auto& get_variations() {
+		const auto& get_variations() const {
 			return variations;
 		}
+
+		std::size_t get_resident_bytes() const;
 	};
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 namespace augs {
 	struct sound_buffer_meta {
 		double computed_length_in_seconds = -1.0;
+		std::size_t resident_bytes = 0;
 
 		bool is_set() const {
 			return computed_length_in_seconds >= 0.0;
@@ -27,5 +28,8 @@ namespace augs {
 	struct sound_buffer_loading_input {
 		const augs::path_type source_sound;
 		const sound_buffer_loading_settings settings;
+
+		/* Sounds that are longer are decoded only as they play. Non-positive values disable streaming. */
+		const double stream_if_longer_than_secs = -1.0;
 	};
 }
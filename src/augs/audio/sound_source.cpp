@@ -9,11 +9,16 @@
 #include <AL/efx.h>
 #endif
 
+#include <cmath>
+#include <algorithm>
+
+#include "augs/log.h"
 #include "augs/math/vec2.h"
 #include "augs/math/si_scaling.h"
 
 #include "augs/audio/sound_source.h"
 #include "augs/audio/sound_buffer.h"
+#include "augs/audio/sound_stream.h"
 
 #include "augs/audio/OpenAL_error.h"
 
@@ -22,6 +27,138 @@ int g_num_sources = 0;
 #endif
 
 namespace augs {
+	static constexpr std::size_t num_stream_buffers = 4;
+	static constexpr double stream_buffer_secs = 0.25;
+
+	/*
+		A ring of OpenAL buffers queued on a single source.
+		Whenever the source is done with one, it is refilled with the next chunk of the sound and queued again.
+	*/
+
+	struct sound_source_stream {
+		struct queued_buffer {
+			ALuint id = 0;
+			double start_secs = 0.0;
+		};
+
+		sound_stream decoder;
+		const ALuint source;
+		std::array<ALuint, num_stream_buffers> buffers = {};
+
+		/* Oldest first. */
+		std::array<queued_buffer, num_stream_buffers> queued = {};
+		std::size_t first_queued = 0;
+		std::size_t num_queued = 0;
+
+		std::vector<sound_sample_type> samples;
+		double decoded_secs = 0.0;
+
+		bool looping = false;
+		bool reached_end = false;
+
+		sound_source_stream(const path_type& path, const ALuint source) : decoder(path), source(source) {
+			AL_CHECK(alGenBuffers(static_cast<int>(buffers.size()), buffers.data()));
+		}
+
+		~sound_source_stream() {
+			AL_CHECK(alDeleteBuffers(static_cast<int>(buffers.size()), buffers.data()));
+		}
+
+		sound_source_stream(const sound_source_stream&) = delete;
+		sound_source_stream& operator=(const sound_source_stream&) = delete;
+
+		void queue_next(const ALuint buffer) {
+			const auto frequency = decoder.get_frequency();
+			const auto channels = decoder.get_channels();
+			const auto samples_per_second = static_cast<double>(frequency * channels);
+
+			samples.resize(static_cast<std::size_t>(frequency * stream_buffer_secs) * channels);
+
+			const auto start_secs = decoded_secs;
+			std::size_t num_decoded = 0;
+			bool rewound = false;
+
+			while (num_decoded < samples.size()) {
+				const auto n = decoder.decode(samples.data() + num_decoded, samples.size() - num_decoded);
+
+				if (n == 0) {
+					/* Rewinding twice in a row means there is nothing to decode at all. */
+					if (!looping || rewound) {
+						reached_end = true;
+						break;
+					}
+
+					decoder.seek_to(0.0);
+					decoded_secs = 0.0;
+					rewound = true;
+					continue;
+				}
+
+				rewound = false;
+				num_decoded += n;
+				decoded_secs += n / samples_per_second;
+			}
+
+			if (num_decoded == 0) {
+				return;
+			}
+
+			AL_CHECK(alBufferData(buffer, AL_FORMAT_STEREO16, samples.data(), static_cast<int>(num_decoded * sizeof(sound_sample_type)), frequency));
+			AL_CHECK(alSourceQueueBuffers(source, 1, &buffer));
+
+			queued[(first_queued + num_queued) % num_stream_buffers] = { buffer, start_secs };
+			++num_queued;
+		}
+
+		void restart(const double from_secs) {
+			/* Setting a null buffer on a stopped source unqueues everything. */
+			AL_CHECK(alSourceStop(source));
+			AL_CHECK(alSourcei(source, AL_BUFFER, 0));
+
+			first_queued = 0;
+			num_queued = 0;
+			reached_end = false;
+
+			decoder.seek_to(from_secs);
+			decoded_secs = std::clamp(from_secs, 0.0, decoder.get_length_in_seconds());
+
+			for (const auto b : buffers) {
+				queue_next(b);
+			}
+		}
+
+		void refill() {
+			int processed = 0;
+			AL_CHECK(alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed));
+
+			while (processed-- > 0 && num_queued > 0) {
+				ALuint buffer = 0;
+				AL_CHECK(alSourceUnqueueBuffers(source, 1, &buffer));
+
+				first_queued = (first_queued + 1) % num_stream_buffers;
+				--num_queued;
+
+				if (!reached_end) {
+					queue_next(buffer);
+				}
+			}
+		}
+
+		double get_time_in_seconds() const {
+			if (num_queued == 0) {
+				return reached_end ? decoder.get_length_in_seconds() : 0.0;
+			}
+
+			float offset = 0.f;
+			AL_CHECK(alGetSourcef(source, AL_SEC_OFFSET, &offset));
+
+			const auto length = decoder.get_length_in_seconds();
+			const auto secs = queued[first_queued].start_secs + offset;
+
+			return length > 0.0 ? std::fmod(secs, length) : 0.0;
+		}
+	};
+
 	float convert_audio_volume(const float slider) {
 		constexpr float min_log = 0.001;
 		constexpr float max_log = 1.0;
@@ -65,7 +202,8 @@ namespace augs {
 		initialized(b.initialized),
 		id(b.id),
 		attached_buffer(b.attached_buffer),
-		buffer_meta(std::move(b.buffer_meta))
+		buffer_meta(std::move(b.buffer_meta)),
+		stream(std::move(b.stream))
 	{
 		b.initialized = false;
 		b.buffer_meta = {};
@@ -78,6 +216,7 @@ namespace augs {
 		id = b.id;
 		attached_buffer = b.attached_buffer;
 		buffer_meta = std::move(b.buffer_meta);
+		stream = std::move(b.stream);
 
 		b.buffer_meta = {};
 		b.initialized = false;
@@ -88,6 +227,7 @@ namespace augs {
 	void sound_source::destroy() {
 		if (initialized) {
 			stop();
+			release_stream();
 #if TRACE_CONSTRUCTORS_DESTRUCTORS
 			--g_num_sources;
 			LOG("alDeleteSources: %x (now %x sources)", id, g_num_sources);
@@ -107,17 +247,65 @@ namespace augs {
 		return get_id();
 	}
 
+	void sound_source::release_stream() {
+		if (stream) {
+			AL_CHECK(alSourceStop(id));
+			AL_CHECK(alSourcei(id, AL_BUFFER, 0));
+			stream.reset();
+		}
+	}
+
+	void sound_source::update_stream() {
+		if (stream == nullptr || stopped) {
+			return;
+		}
+
+		stream->refill();
+
+#if BUILD_OPENAL
+		ALenum state = 0xdeadbeef;
+		AL_CHECK(alGetSourcei(id, AL_SOURCE_STATE, &state));
+
+		if (state != AL_PLAYING && stream->num_queued > 0) {
+			/* The source has starved before we could refill it. */
+			AL_CHECK(alSourcePlay(id));
+		}
+#endif
+	}
+
 	void sound_source::play() {
+		if (stream) {
+			/* Just like with a resident buffer, playing starts over. */
+			stream->restart(0.0);
+		}
+
 		AL_CHECK(alSourcePlay(id));
 		stopped = false;
 	}
 	
 	void sound_source::seek_to(const float seconds) const {
 		(void)seconds;
+
+		if (stream) {
+			const bool was_playing = is_playing();
+
+			stream->restart(seconds);
+
+			if (was_playing) {
+				AL_CHECK(alSourcePlay(id));
+			}
+
+			return;
+		}
+
 		AL_CHECK(alSourcef(id, AL_SEC_OFFSET, seconds));
 	}
 	
 	float sound_source::get_time_in_seconds() const {
+		if (stream) {
+			return static_cast<float>(stream->get_time_in_seconds());
+		}
+
 		float seconds = 0.f;
 		AL_CHECK(alGetSourcef(id, AL_SEC_OFFSET, &seconds));
 		return seconds;
@@ -130,6 +318,14 @@ namespace augs {
 	
 	void sound_source::set_looping(const bool loop) const {
 		(void)loop;
+
+		if (stream) {
+			/* A looping source would replay its queue instead of asking for more. */
+			stream->looping = loop;
+			AL_CHECK(alSourcei(id, AL_LOOPING, AL_FALSE));
+			return;
+		}
+
 		AL_CHECK(alSourcei(id, AL_LOOPING, loop));
 #if TRACE_PARAMETERS
 		LOG_NVPS(loop);
@@ -295,6 +491,12 @@ namespace augs {
 
 		ALenum state = 0xdeadbeef;
 		AL_CHECK(alGetSourcei(id, AL_SOURCE_STATE, &state));
+
+		if (stream) {
+			/* A starved stream will resume on the next update. */
+			return state == AL_PLAYING || !stream->reached_end;
+		}
+
 		return state == AL_PLAYING;
 #else
 		return false;
@@ -313,6 +515,7 @@ namespace augs {
 		}
 
 		const bool reseek = is_playing();
+
 		std::optional<float> previous_seconds;
 
 		if (reseek) {
@@ -321,6 +524,39 @@ namespace augs {
 			}
 		}
 
+		if (buf.is_streamed()) {
+			const bool was_looping = stream != nullptr && stream->looping;
+
+			release_stream();
+
+			try {
+				stream = std::make_unique<sound_source_stream>(buf.get_streamed_path(), id);
+				stream->looping = was_looping;
+			}
+			catch (const sound_decoding_error& err) {
+				LOG("Failed to stream %x: %x", buf.get_streamed_path(), err.what());
+			}
+
+			buffer_meta = buf.get_meta();
+
+			if (reseek) {
+				if (stream && previous_seconds) {
+					/* Unlike play(), pick up where the previous buffer was. */
+					stream->restart(std::min(buffer_meta.computed_length_in_seconds, static_cast<double>(*previous_seconds)));
+
+					AL_CHECK(alSourcePlay(id));
+					stopped = false;
+				}
+				else {
+					play();
+				}
+			}
+
+			return;
+		}
+
+		release_stream();
+
 		if (previous_seconds) {
 			stop();
 		}
@@ -348,6 +584,8 @@ namespace augs {
 	}
 
 	void sound_source::unbind_buffer() {
+		release_stream();
+
 		attached_buffer = 0;
 		buffer_meta = {};
 		AL_CHECK(alSourcei(id, AL_BUFFER, 0));
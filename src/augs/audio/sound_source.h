@@ -1,5 +1,6 @@
 #pragma once
 #include <array>
+#include <memory>
 #include <stdexcept>
 
 #include "augs/math/vec2.h"
@@ -19,6 +20,7 @@ namespace augs {
 namespace augs {
 	class single_sound_buffer;
 	class sound_buffer;
+	struct sound_source_stream;
 
 	void set_listener_velocity(const si_scaling, vec2);
 	void set_listener_position(const si_scaling, vec2);
@@ -31,7 +33,11 @@ namespace augs {
 		ALuint attached_buffer = -1;
 		sound_buffer_meta buffer_meta;
 
+		/* Only set while a streamed buffer is bound. */
+		std::unique_ptr<sound_source_stream> stream;
+
 		void destroy();
+		void release_stream();
 	public:
 		sound_source();
 		~sound_source();
@@ -78,6 +84,9 @@ namespace augs {
 
 		void unbind_buffer();
 
+		/* Refills the buffers of a streamed sound that have already been played. */
+		void update_stream();
+
 		const sound_buffer_meta& get_bound_buffer_meta() const {
 			return buffer_meta;
 		}
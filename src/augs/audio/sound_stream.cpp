@@ -0,0 +1,133 @@
+#if PLATFORM_UNIX
+/* Necessary for some stuff in ogg library */
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+#include <algorithm>
+
+#if BUILD_SOUND_FORMAT_DECODERS
+#include <ogg/ogg.h>
+#include <vorbis/vorbisfile.h>
+#endif
+
+#include "augs/audio/sound_stream.h"
+
+namespace augs {
+	struct sound_stream::decoder {
+#if BUILD_SOUND_FORMAT_DECODERS
+		OggVorbis_File file;
+		bool opened = false;
+
+		~decoder() {
+			if (opened) {
+				ov_clear(&file);
+			}
+		}
+#endif
+	};
+
+	bool can_be_streamed(const path_type& path) {
+#if BUILD_SOUND_FORMAT_DECODERS
+		return path.extension() == ".ogg";
+#else
+		(void)path;
+		return false;
+#endif
+	}
+
+	sound_stream::sound_stream(const path_type& path) {
+		if (!can_be_streamed(path)) {
+			throw sound_decoding_error("Failed to stream %x: only .ogg files can be streamed.", path);
+		}
+
+#if BUILD_SOUND_FORMAT_DECODERS
+		ogg = std::make_unique<decoder>();
+
+		if (0 != ov_fopen(path.string().c_str(), &ogg->file)) {
+			throw sound_decoding_error("Error! Failed to load %x.", path);
+		}
+
+		ogg->opened = true;
+
+		const auto* const info = ov_info(&ogg->file, -1);
+
+		channels = info->channels;
+		frequency = info->rate;
+		length_in_seconds = ov_time_total(&ogg->file, -1);
+
+		if (channels != 1 && channels != 2) {
+			throw sound_decoding_error("Failed to stream %x: %x channels are not supported.", path, channels);
+		}
+#endif
+	}
+
+	sound_stream::~sound_stream() = default;
+
+	sound_stream::sound_stream(sound_stream&&) noexcept = default;
+	sound_stream& sound_stream::operator=(sound_stream&&) noexcept = default;
+
+	std::size_t sound_stream::decode(sound_sample_type* const output, const std::size_t max_samples) {
+#if BUILD_SOUND_FORMAT_DECODERS
+		const bool is_mono = channels == 1;
+
+		auto* const target = [&]() {
+			if (is_mono) {
+				mono_samples.resize(max_samples / 2);
+				return mono_samples.data();
+			}
+
+			return output;
+		}();
+
+		const auto max_target_samples = is_mono ? max_samples / 2 : max_samples;
+		const auto max_bytes = max_target_samples * sizeof(sound_sample_type);
+
+		std::size_t bytes_decoded = 0;
+
+		while (bytes_decoded < max_bytes) {
+			int bit_stream = 0;
+
+			const auto bytes = ov_read(
+				&ogg->file,
+				reinterpret_cast<char*>(target) + bytes_decoded,
+				static_cast<int>(max_bytes - bytes_decoded),
+				0,
+				2,
+				1,
+				&bit_stream
+			);
+
+			if (bytes <= 0) {
+				break;
+			}
+
+			bytes_decoded += static_cast<std::size_t>(bytes);
+		}
+
+		const auto samples_decoded = bytes_decoded / sizeof(sound_sample_type);
+
+		if (is_mono) {
+			for (std::size_t i = 0; i < samples_decoded; ++i) {
+				output[i * 2] = mono_samples[i];
+				output[i * 2 + 1] = mono_samples[i];
+			}
+
+			return samples_decoded * 2;
+		}
+
+		return samples_decoded;
+#else
+		(void)output;
+		(void)max_samples;
+		return 0;
+#endif
+	}
+
+	void sound_stream::seek_to(const double seconds) {
+#if BUILD_SOUND_FORMAT_DECODERS
+		ov_time_seek(&ogg->file, std::clamp(seconds, 0.0, length_in_seconds));
+#else
+		(void)seconds;
+#endif
+	}
+}
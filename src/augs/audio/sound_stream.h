@@ -0,0 +1,50 @@
+#pragma once
+#include <memory>
+
+#include "augs/audio/sound_data.h"
+
+namespace augs {
+	/*
+		Decodes an .ogg file a chunk at a time,
+		so that only the chunks queued for playback are ever held in memory.
+
+		Just like sound_data, mono sounds come out as stereo.
+	*/
+
+	class sound_stream {
+		struct decoder;
+
+		std::unique_ptr<decoder> ogg;
+		std::vector<sound_sample_type> mono_samples;
+
+		int frequency = 0;
+		int channels = 0;
+		double length_in_seconds = 0.0;
+
+	public:
+		sound_stream(const path_type& path);
+		~sound_stream();
+
+		sound_stream(sound_stream&&) noexcept;
+		sound_stream& operator=(sound_stream&&) noexcept;
+
+		/* Returns the number of samples written, or 0 once the end has been reached. */
+		std::size_t decode(sound_sample_type* output, std::size_t max_samples);
+
+		void seek_to(double seconds);
+
+		int get_frequency() const {
+			return frequency;
+		}
+
+		int get_channels() const {
+			return 2;
+		}
+
+		double get_length_in_seconds() const {
+			return length_in_seconds;
+		}
+	};
+
+	bool can_be_streamed(const path_type& path);
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <tuple>
 #include <vector>
 
@@ -67,6 +68,25 @@ namespace augs {
 			});
 		}
 
+		using queue_sizes = std::array<std::size_t, sizeof...(Queues)>;
+
+		queue_sizes get_queue_sizes() const {
+			return { std::get<make_vector<Queues>>(queues).size()... };
+		}
+
+		/* Appends only the messages that were posted to b after b_sizes_before were taken. */
+		void append_posted_since(const storage_for_message_queues& b, const queue_sizes& b_sizes_before) {
+			auto c = [&](auto& q) {
+				using Q = remove_cref<decltype(q)>;
+				constexpr auto i = index_in_v<typename Q::value_type, Queues...>;
+
+				const auto& from = std::get<Q>(b.queues);
+				q.insert(q.end(), from.begin() + b_sizes_before[i], from.end());
+			};
+
+			::unfold<make_vector, Queues...>(queues, c);
+		}
+
 		auto& operator+=(const storage_for_message_queues& b) {
 			auto c = [&](auto& q) {
 				concatenate(q, std::get<remove_cref<decltype(q)>>(b.queues));
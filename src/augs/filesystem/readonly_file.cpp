@@ -0,0 +1,130 @@
+#if PLATFORM_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+#else
+#include <cstring>
+#endif
+
+#include "augs/filesystem/readonly_file.h"
+#include "augs/readwrite/byte_file.h"
+
+namespace augs {
+#if PLATFORM_UNIX
+	struct readonly_file_stat {
+		std::size_t size = 0;
+		int64_t last_write_time_ns = 0;
+
+		bool operator==(const readonly_file_stat&) const = default;
+	};
+
+	static bool stat_fd(const int fd, readonly_file_stat& out) {
+		struct stat st;
+
+		if (::fstat(fd, &st) == -1) {
+			return false;
+		}
+
+#if PLATFORM_MACOS
+		const auto& mtime = st.st_mtimespec;
+#else
+		const auto& mtime = st.st_mtim;
+#endif
+
+		out.size = static_cast<std::size_t>(st.st_size);
+		out.last_write_time_ns = int64_t(mtime.tv_sec) * 1000000000 + int64_t(mtime.tv_nsec);
+
+		return true;
+	}
+
+	readonly_file::readonly_file(const path_type& path) {
+		fd = ::open(path.c_str(), O_RDONLY);
+
+		if (fd == -1) {
+			throw readonly_file_error("Failed to open %x: %x", path, std::strerror(errno));
+		}
+
+		readonly_file_stat st;
+
+		if (!stat_fd(fd, st)) {
+			const auto reason = std::strerror(errno);
+			::close(fd);
+
+			throw readonly_file_error("Failed to stat %x: %x", path, reason);
+		}
+
+		n = st.size;
+		last_write_time_ns = st.last_write_time_ns;
+	}
+
+	readonly_file::~readonly_file() {
+		::close(fd);
+	}
+
+	bool readonly_file::changed_on_disk() const {
+		readonly_file_stat st;
+
+		if (!stat_fd(fd, st)) {
+			return true;
+		}
+
+		return !(st == readonly_file_stat { n, last_write_time_ns });
+	}
+
+	bool readonly_file::read(const std::size_t offset, std::byte* const output, const std::size_t num_bytes) const {
+		if (offset + num_bytes > n || changed_on_disk()) {
+			return false;
+		}
+
+		std::size_t total = 0;
+
+		while (total < num_bytes) {
+			const auto result = ::pread(fd, output + total, num_bytes - total, static_cast<off_t>(offset + total));
+
+			if (result < 0 && errno == EINTR) {
+				continue;
+			}
+
+			if (result <= 0) {
+				return false;
+			}
+
+			total += static_cast<std::size_t>(result);
+		}
+
+		/* The file might have been rewritten while it was being read. */
+		return !changed_on_disk();
+	}
+#else
+	readonly_file::readonly_file(const path_type& path) {
+		try {
+			file_to_bytes(path, snapshot);
+		}
+		catch (const std::exception& err) {
+			throw readonly_file_error("Failed to read %x: %x", path, err.what());
+		}
+
+		n = snapshot.size();
+	}
+
+	readonly_file::~readonly_file() = default;
+
+	bool readonly_file::changed_on_disk() const {
+		return false;
+	}
+
+	bool readonly_file::read(const std::size_t offset, std::byte* const output, const std::size_t num_bytes) const {
+		if (offset + num_bytes > n) {
+			return false;
+		}
+
+		if (num_bytes > 0) {
+			std::memcpy(output, snapshot.data() + offset, num_bytes);
+		}
+
+		return true;
+	}
+#endif
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "augs/filesystem/path.h"
+#include "augs/templates/exception_templates.h"
+
+namespace augs {
+	struct readonly_file_error : error_with_typesafe_sprintf {
+		using error_with_typesafe_sprintf::error_with_typesafe_sprintf;
+	};
+
+	/*
+		A file kept open for reading parts of it, possibly from many threads at once.
+
+		On Unix the parts are read straight from the page cache with pread,
+		so the file is never held in memory as a whole.
+		It is not mapped into memory on purpose:
+		touching a mapped page past the end of a file truncated in the meantime raises SIGBUS.
+		Every read also checks that the file was not changed on disk since it was opened.
+
+		Elsewhere the file is simply read into memory when opened.
+	*/
+
+	class readonly_file {
+		std::size_t n = 0;
+
+#if PLATFORM_UNIX
+		int fd = -1;
+		int64_t last_write_time_ns = 0;
+#else
+		std::vector<std::byte> snapshot;
+#endif
+
+	public:
+		explicit readonly_file(const path_type& path);
+		~readonly_file();
+
+		readonly_file(const readonly_file&) = delete;
+		readonly_file& operator=(const readonly_file&) = delete;
+
+		std::size_t size() const {
+			return n;
+		}
+
+		bool empty() const {
+			return n == 0;
+		}
+
+		bool changed_on_disk() const;
+
+		/* Returns false if the read failed or if the file changed on disk since it was opened. */
+		bool read(std::size_t offset, std::byte* output, std::size_t num_bytes) const;
+
+		template <class F>
+		bool for_each_block(F&& callback) const {
+			std::array<std::byte, 16 * 1024> block;
+
+			for (std::size_t offset = 0; offset < n; offset += block.size()) {
+				const auto num_bytes = std::min(block.size(), n - offset);
+
+				if (!read(offset, block.data(), num_bytes)) {
+					return false;
+				}
+
+				callback(block.data(), num_bytes);
+			}
+
+			return true;
+		}
+	};
+}
@@ -676,10 +676,9 @@ namespace augs {
 	}
 
 	image& image::desaturate() {
-		for (unsigned y = 0; y < size.y; ++y) {
-			for (unsigned x = 0; x < size.x; ++x) {
-				pixel({ x, y }).desaturate();
-			}
+		/* A flat pass over the pixels without per-pixel indexing, so that it vectorizes. */
+		for (auto& p : v) {
+			p.desaturate();
 		}
 
 		return *this;
@@ -87,22 +87,41 @@ namespace augs {
 #if DISABLE_COMPRESSION
 		output.assign(input, input + byte_count);
 #else
-		const auto uncompressed_size = output.size();
+		try {
+			decompress(input, byte_count, output.data(), output.size());
+		}
+		catch (...) {
+			output.clear();
+			throw;
+		}
+#endif
+	}
+
+	void decompress(
+		const std::byte* const input,
+		const std::size_t byte_count,
+		std::byte* const output,
+		const std::size_t uncompressed_size
+	) {
+#if DISABLE_COMPRESSION
+		if (byte_count != uncompressed_size) {
+			throw decompression_error("Decompression failure. Read %x bytes, but expected %x.", byte_count, uncompressed_size);
+		}
 
+		std::copy(input, input + byte_count, output);
+#else
 		const auto bytes_read = LZ4_decompress_safe(
 			reinterpret_cast<const char*>(input), 
-			reinterpret_cast<char*>(output.data()), 
+			reinterpret_cast<char*>(output), 
 			byte_count,
 			static_cast<int>(uncompressed_size)
 		);
 
 		if (bytes_read < 0) {
-			output.clear();
 			throw decompression_error("CHECK IF YOU PASSED CORRECT uncompressed_size! Decompression failure. Failed to read any bytes.");
 		}
 
 		if (uncompressed_size != static_cast<std::size_t>(bytes_read)) {
-			output.clear();
 			throw decompression_error("CHECK IF YOU PASSED CORRECT uncompressed_size! Decompression failure. Read %x bytes, but expected %x.", bytes_read, uncompressed_size);
 		}
 #endif
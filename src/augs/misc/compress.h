@@ -42,4 +42,11 @@ namespace augs {
 		const std::vector<std::byte>& input,
 		std::vector<std::byte>& output
 	);
+
+	void decompress(
+		const std::byte* input,
+		std::size_t byte_count,
+		std::byte* output,
+		std::size_t uncompressed_size
+	);
 }
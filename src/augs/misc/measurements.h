@@ -6,6 +6,7 @@
 #include "augs/math/vec2.h"
 #include "augs/templates/algorithm_templates.h"
 #include "augs/misc/timing/timer.h"
+#include "augs/misc/time_histogram.h"
 #include "augs/misc/scope_guard.h"
 
 namespace augs {
@@ -143,7 +144,14 @@ namespace augs {
 
 	public:
 		using base::base;
-		using base::measure;
+
+		/* Unlike the tracked window, keeps every measurement until cleared, so that spikes are never averaged out. */
+		time_histogram histogram;
+
+		void measure(const double value) {
+			base::measure(value);
+			histogram.record(value);
+		}
 
 		void start() {
 			tm.reset();
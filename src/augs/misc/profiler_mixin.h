@@ -1,4 +1,5 @@
 #pragma once
+#include <utility>
 #include "augs/templates/introspect_declaration.h"
 #include "augs/templates/algorithm_templates.h"
 #include "augs/string/string_templates_declaration.h"
@@ -47,6 +48,87 @@ namespace augs {
 			);
 		}
 
+		/*
+			Writes every measurement in the Prometheus text format.
+			Durations are written as summaries whose quantiles cover the time since the last clear_histograms(),
+			while their _sum and _count are cumulative so that rate() works.
+			The maximum since the last clear_histograms() is a separate gauge.
+
+			The labels, e.g. arena="8412", are added to every sample
+			so that several writers can be told apart.
+		*/
+
+		static std::string metric_labels(const std::string& labels, const std::string& own_labels = "") {
+			if (labels.empty() && own_labels.empty()) {
+				return "";
+			}
+
+			if (labels.empty() || own_labels.empty()) {
+				return "{" + labels + own_labels + "}";
+			}
+
+			return "{" + labels + "," + own_labels + "}";
+		}
+
+		void write_metrics(std::string& output, const std::string& prefix, const std::string& labels = "") const {
+			auto& self = *static_cast<const derived*>(this);
+			const auto all_labels = metric_labels(labels);
+
+			for_each_measurement(
+				[&](const auto& label, const auto& m) {
+					using T = remove_cref<decltype(m)>;
+
+					if constexpr(std::is_same_v<T, time_measurements>) {
+						const auto name = typesafe_sprintf("%x%x_seconds", prefix, label);
+						const auto& h = m.histogram;
+
+						output += typesafe_sprintf("# TYPE %x summary\n", name);
+
+						const std::pair<const char*, double> quantiles[] = {
+							{ "0.5", 0.5 },
+							{ "0.99", 0.99 },
+							{ "0.999", 0.999 }
+						};
+
+						for (const auto& q : quantiles) {
+							const auto quantile_labels = metric_labels(labels, typesafe_sprintf("quantile=\"%x\"", q.first));
+							output += typesafe_sprintf("%x%x %x\n", name, quantile_labels, h.percentile_secs(q.second));
+						}
+
+						output += typesafe_sprintf("%x_sum%x %x\n", name, all_labels, h.get_cumulative_sum_secs());
+						output += typesafe_sprintf("%x_count%x %x\n", name, all_labels, h.get_cumulative_count());
+
+						const auto max_name = typesafe_sprintf("%x%x_max_seconds", prefix, label);
+
+						output += typesafe_sprintf("# TYPE %x gauge\n", max_name);
+						output += typesafe_sprintf("%x%x %x\n", max_name, all_labels, h.get_max_secs());
+					}
+					else {
+						const auto name = typesafe_sprintf("%x%x", prefix, label);
+
+						output += typesafe_sprintf("# TYPE %x gauge\n", name);
+						output += typesafe_sprintf("%x%x %x\n", name, all_labels, m.get_last_measurement_units());
+					}
+				},
+				self
+			);
+		}
+
+		void clear_histograms() {
+			auto& self = *static_cast<derived*>(this);
+
+			for_each_measurement(
+				[](const auto&, auto& m) {
+					using T = remove_cref<decltype(m)>;
+
+					if constexpr(std::is_same_v<T, time_measurements>) {
+						m.histogram.clear();
+					}
+				},
+				self
+			);
+		}
+
 		void summary(std::string& output) const {
 			thread_local std::vector<const time_measurements*> all_with_time;
 			thread_local std::string amounts_summary;
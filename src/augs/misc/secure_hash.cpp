@@ -1,5 +1,6 @@
 #include <sstream>
 #include <iomanip>
+#include <new>
 
 #include "augs/misc/secure_hash.h"
 #include "3rdparty/blake3/blake3.h"
@@ -100,4 +101,111 @@ namespace augs {
 
 		return output;
 	}
+
+	static_assert(sizeof(blake3_hasher) <= 2048);
+	static_assert(alignof(blake3_hasher) <= 16);
+
+	incremental_secure_hash::incremental_secure_hash(const bool convert_crlf_to_lf) 
+		: convert_crlf_to_lf(convert_crlf_to_lf) 
+	{
+		blake3_hasher_init(new (hasher_storage.data()) blake3_hasher);
+	}
+
+	void incremental_secure_hash::flush() {
+		auto& hasher = *reinterpret_cast<blake3_hasher*>(hasher_storage.data());
+
+		blake3_hasher_update(&hasher, pending.data(), num_pending);
+		num_pending = 0;
+	}
+
+	void incremental_secure_hash::push(const std::byte b) {
+		if (num_pending == pending.size()) {
+			flush();
+		}
+
+		pending[num_pending++] = b;
+	}
+
+	void incremental_secure_hash::update(const std::byte* const bytes, const std::size_t n) {
+		if (!convert_crlf_to_lf) {
+			flush();
+
+			auto& hasher = *reinterpret_cast<blake3_hasher*>(hasher_storage.data());
+			blake3_hasher_update(&hasher, bytes, n);
+
+			return;
+		}
+
+		/* A CR at the end of one part might be followed by an LF at the start of the next one. */
+
+		for (std::size_t i = 0; i < n; ++i) {
+			const auto b = bytes[i];
+
+			if (pending_cr) {
+				pending_cr = false;
+
+				if (b == std::byte('\n')) {
+					push(b);
+					continue;
+				}
+
+				push(std::byte('\r'));
+			}
+
+			if (b == std::byte('\r')) {
+				pending_cr = true;
+			}
+			else {
+				push(b);
+			}
+		}
+	}
+
+	secure_hash_type incremental_secure_hash::finalize() {
+		if (pending_cr) {
+			pending_cr = false;
+			push(std::byte('\r'));
+		}
+
+		flush();
+
+		auto& hasher = *reinterpret_cast<blake3_hasher*>(hasher_storage.data());
+
+		secure_hash_type output;
+		blake3_hasher_finalize(&hasher, output.data(), output.size());
+
+		return output;
+	}
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("SecureHash IncrementalCrlfToLf") {
+	const std::string text = "a\r\nb\r\r\nc\n\rd\r\r\r\ne\r";
+
+	const auto expected = augs::secure_hash(augs::crlf_to_lf_string(text));
+
+	for (std::size_t split = 0; split <= text.size(); ++split) {
+		augs::incremental_secure_hash hash(true);
+
+		const auto bytes = reinterpret_cast<const std::byte*>(text.data());
+
+		hash.update(bytes, split);
+		hash.update(bytes + split, text.size() - split);
+
+		REQUIRE(hash.finalize() == expected);
+	}
+
+	{
+		augs::incremental_secure_hash hash;
+
+		const auto bytes = reinterpret_cast<const std::byte*>(text.data());
+
+		hash.update(bytes, 3);
+		hash.update(bytes + 3, text.size() - 3);
+
+		REQUIRE(hash.finalize() == augs::secure_hash(text));
+	}
 }
+#endif
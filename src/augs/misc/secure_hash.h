@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <vector>
 #include <cstddef>
 #include <string>
@@ -42,6 +43,30 @@ namespace augs {
 	inline secure_hash_type secure_hash(const std::vector<std::byte>& bytes) {
 		return secure_hash(bytes.data(), bytes.size());
 	}
+
+	/*
+		Hashes bytes fed in any number of parts as if they were a single buffer,
+		optionally converting CRLF to LF on the fly,
+		so that a large file never has to be held in memory just to be hashed.
+	*/
+
+	class incremental_secure_hash {
+		alignas(16) std::array<std::byte, 2048> hasher_storage;
+		std::array<std::byte, 4096> pending;
+		std::size_t num_pending = 0;
+
+		bool convert_crlf_to_lf = false;
+		bool pending_cr = false;
+
+		void push(std::byte b);
+		void flush();
+
+	public:
+		explicit incremental_secure_hash(bool convert_crlf_to_lf = false);
+
+		void update(const std::byte* bytes, std::size_t n);
+		secure_hash_type finalize();
+	};
 }
 
 namespace std {
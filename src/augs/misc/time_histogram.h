@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+namespace augs {
+	/*
+		Counts durations in buckets of microseconds.
+		Every power of two is split into a few linear sub-buckets,
+		so any percentile is known within an eighth of its value,
+		from a single microsecond up to over two minutes, with a fixed amount of memory.
+
+		clear() only resets the buckets and the maximum.
+		The cumulative count and sum keep growing, as monotonic counters should.
+	*/
+
+	class time_histogram {
+		static constexpr unsigned sub_bucket_bits = 3;
+		static constexpr unsigned sub_buckets = 1u << sub_bucket_bits;
+		static constexpr unsigned magnitudes = 28;
+		static constexpr unsigned num_buckets = magnitudes * sub_buckets;
+
+		std::array<uint32_t, num_buckets> counts = {};
+		uint64_t total = 0;
+		double max_secs = 0.0;
+
+		uint64_t cumulative_count = 0;
+		double cumulative_sum_secs = 0.0;
+
+		static unsigned bucket_of(const uint64_t us) {
+			if (us < sub_buckets) {
+				return static_cast<unsigned>(us);
+			}
+
+			const auto shift = static_cast<unsigned>(std::bit_width(us)) - 1 - sub_bucket_bits;
+			const auto sub = static_cast<unsigned>(us >> shift) - sub_buckets;
+
+			return std::min(num_buckets - 1, sub_buckets * (shift + 1) + sub);
+		}
+
+		static double upper_bound_secs_of(const unsigned bucket) {
+			const auto block = bucket / sub_buckets;
+			const auto sub = bucket % sub_buckets;
+
+			if (block == 0) {
+				return (sub + 1) / 1e6;
+			}
+
+			const auto upper_us = static_cast<uint64_t>(sub_buckets + sub + 1) << (block - 1);
+			return static_cast<double>(upper_us) / 1e6;
+		}
+
+	public:
+		void record(const double secs) {
+			const auto us = static_cast<uint64_t>(std::max(0.0, secs) * 1e6);
+
+			++counts[bucket_of(us)];
+			++total;
+
+			++cumulative_count;
+			cumulative_sum_secs += std::max(0.0, secs);
+
+			max_secs = std::max(max_secs, secs);
+		}
+
+		/* Returns the upper bound of the bucket, never more than the maximum recorded duration. */
+		double percentile_secs(const double q) const {
+			if (total == 0) {
+				return 0.0;
+			}
+
+			const auto target = std::max(uint64_t(1), static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+
+			uint64_t cumulative = 0;
+
+			for (unsigned i = 0; i < num_buckets; ++i) {
+				cumulative += counts[i];
+
+				if (cumulative >= target) {
+					return std::min(max_secs, upper_bound_secs_of(i));
+				}
+			}
+
+			return max_secs;
+		}
+
+		double get_max_secs() const {
+			return max_secs;
+		}
+
+		uint64_t get_count() const {
+			return total;
+		}
+
+		uint64_t get_cumulative_count() const {
+			return cumulative_count;
+		}
+
+		double get_cumulative_sum_secs() const {
+			return cumulative_sum_secs;
+		}
+
+		time_histogram& operator+=(const time_histogram& b) {
+			for (unsigned i = 0; i < num_buckets; ++i) {
+				counts[i] += b.counts[i];
+			}
+
+			total += b.total;
+			max_secs = std::max(max_secs, b.max_secs);
+
+			cumulative_count += b.cumulative_count;
+			cumulative_sum_secs += b.cumulative_sum_secs;
+
+			return *this;
+		}
+
+		void clear() {
+			counts = {};
+			total = 0;
+			max_secs = 0.0;
+		}
+	};
+}
@@ -1,108 +1,166 @@
 #pragma once
+#include <cmath>
 #include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
 
 namespace augs {
-	template<class command>
+	struct jitter_buffer_stats {
+		std::size_t occupancy = 0;
+		std::size_t target_depth = 0;
+		float jitter_steps = 0.f;
+
+		/* Totals since the last reset_counters. */
+		uint32_t steps_extrapolated = 0;
+		uint32_t catch_ups = 0;
+		uint32_t overflows = 0;
+	};
+
+	/*
+		Commands of a single client, waiting to be consumed once per step.
+
+		The commands live in a ring that is allocated once,
+		so neither receiving nor consuming them ever allocates.
+
+		The target depth adapts to how irregularly the commands arrive.
+		Ideally, exactly one command arrives per step.
+		Each step, the deviation from that is folded into a running estimate
+		(the same way RFC 3550 estimates the interarrival jitter),
+		and the buffer aims to hold a few times that estimate.
+	*/
+
+	template <class T>
 	class jitter_buffer {
-		size_t lower_limit = 3;
-		unsigned steps_extrapolated = 0;
+		std::vector<T> ring;
+		std::size_t head = 0;
+		std::size_t count = 0;
+
+		uint32_t arrived_this_step = 0;
+		float jitter_steps = 0.f;
+
+		std::size_t min_depth = 1;
+		std::size_t max_depth = 32;
+
+		jitter_buffer_stats counters;
+
+		std::size_t index_of(const std::size_t i) const {
+			return (head + i) % ring.size();
+		}
 
-		bool initial_filling = true;
 	public:
-		std::vector<command> buffer;
-		
-		void acquire_new_command(const command& c) {
-			buffer.push_back(c);
-
-			if (initial_filling) {
-				if (buffer.size() >= lower_limit) {
-					initial_filling = false;
-				}
+		static constexpr float depth_per_jitter_step = 3.f;
+		static constexpr float jitter_smoothing = 1.f / 16;
+
+		void set_capacity(const std::size_t new_capacity) {
+			if (new_capacity == ring.size() || new_capacity < count) {
+				return;
 			}
-		}
 
-		void acquire_new_command(command&& c) {
-			buffer.emplace_back(c);
+			std::vector<T> resized(new_capacity);
 
-			if (initial_filling) {
-				if (buffer.size() >= lower_limit) {
-					initial_filling = false;
-				}
+			for (std::size_t i = 0; i < count; ++i) {
+				resized[i] = std::move(ring[index_of(i)]);
 			}
+
+			ring = std::move(resized);
+			head = 0;
+		}
+
+		std::size_t capacity() const {
+			return ring.size();
 		}
-		
-		template <class Iter>
-		void acquire_new_commands(Iter first, Iter last) {
-			buffer.insert(buffer.end(), first, last);
 
-			if (initial_filling) {
-				if (buffer.size() >= lower_limit) {
-					initial_filling = false;
-				}
+		/* Returns false and drops the command if the buffer is full. */
+		template <class C>
+		bool push(C&& c) {
+			if (count == ring.size()) {
+				++counters.overflows;
+				return false;
 			}
+
+			ring[index_of(count)] = std::forward<C>(c);
+			++count;
+			++arrived_this_step;
+
+			return true;
 		}
 
-		std::vector<command> unpack_commands_once() {
-			std::vector<command> next_commands;
+		T& operator[](const std::size_t i) {
+			return ring[index_of(i)];
+		}
 
-			if (!initial_filling) {
-				const auto steps_to_unpack = steps_extrapolated + 1;
+		const T& operator[](const std::size_t i) const {
+			return ring[index_of(i)];
+		}
 
-				if (buffer.size() >= steps_to_unpack) {
-					next_commands.assign(buffer.begin(), buffer.begin() + steps_to_unpack);
-					buffer		  .erase(buffer.begin(), buffer.begin() + steps_to_unpack);
-				}
+		void pop_front(const std::size_t n = 1) {
+			const auto popped = std::min(n, count);
 
-				const bool unpacked_successfully = next_commands.size() > 0;
+			head = count == popped ? 0 : index_of(popped);
+			count -= popped;
+		}
 
-				if (unpacked_successfully) {
-					steps_extrapolated = 0;
-				}
-				else {
-					++steps_extrapolated;
-				}
-			}
+		std::size_t size() const {
+			return count;
+		}
 
-			return next_commands;
+		bool empty() const {
+			return count == 0;
 		}
 
-		bool unpack_next_command(command& next_command) {
-			if (!initial_filling) {
-				if (buffer.size() > 0) {
-					next_command = std::move(buffer.front());
-					buffer.erase(buffer.begin());
+		void clear() {
+			head = 0;
+			count = 0;
+			arrived_this_step = 0;
+		}
 
-					return true;
-				}
-			}
+		/*
+			Call once per step before consuming.
+			Updates the jitter estimate with the commands that arrived since the previous step.
+		*/
 
-			return false;
+		void begin_step() {
+			const auto deviation = std::abs(static_cast<float>(arrived_this_step) - 1.f);
+			jitter_steps += (deviation - jitter_steps) * jitter_smoothing;
+
+			arrived_this_step = 0;
+
+			if (count == 0) {
+				++counters.steps_extrapolated;
+			}
 		}
 
-		void allow_to_refill() {
-			initial_filling = true;
+		void note_catch_up() {
+			++counters.catch_ups;
 		}
 
-		bool is_still_refilling() const {
-			return initial_filling;
+		void set_depth_limits(const std::size_t new_min, const std::size_t new_max) {
+			min_depth = new_min;
+			max_depth = std::max(new_min, new_max);
 		}
 
-		size_t get_available_command_count() const {
-			return buffer.size();
+		std::size_t get_target_depth() const {
+			const auto adaptive = static_cast<std::size_t>(std::ceil(jitter_steps * depth_per_jitter_step));
+			return std::clamp(adaptive, min_depth, max_depth);
 		}
 
-		size_t get_lower_limit() const {
-			return lower_limit;
+		float get_jitter_steps() const {
+			return jitter_steps;
 		}
 
-		void set_lower_limit(size_t new_lower_limit) {
-			lower_limit = new_lower_limit;
+		jitter_buffer_stats get_stats() const {
+			auto stats = counters;
+
+			stats.occupancy = count;
+			stats.target_depth = get_target_depth();
+			stats.jitter_steps = jitter_steps;
+
+			return stats;
 		}
 
-		unsigned get_steps_extrapolated() const {
-			return steps_extrapolated;
+		void reset_counters() {
+			counters = {};
 		}
 	};
-
-
-}
\ No newline at end of file
+}
@@ -45,4 +45,73 @@ namespace augs {
 			return true;
 		}
 	}
-}
\ No newline at end of file
+}
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/network/jitter_buffer.h"
+
+TEST_CASE("JitterBuffer RingAndAdaptiveDepth") {
+	augs::jitter_buffer<int> buf;
+
+	REQUIRE(!buf.push(0));
+	REQUIRE(buf.get_stats().overflows == 1);
+
+	buf.set_capacity(4);
+
+	for (int i = 0; i < 4; ++i) {
+		REQUIRE(buf.push(i));
+	}
+
+	REQUIRE(!buf.push(4));
+
+	buf.pop_front(3);
+	REQUIRE(buf.size() == 1);
+	REQUIRE(buf[0] == 3);
+
+	/* Wraps around the end of the ring. */
+	REQUIRE(buf.push(4));
+	REQUIRE(buf.push(5));
+	REQUIRE(buf[1] == 4);
+	REQUIRE(buf[2] == 5);
+
+	/* Growing preserves the order. */
+	buf.set_capacity(8);
+	REQUIRE(buf.capacity() == 8);
+	REQUIRE(buf.size() == 3);
+	REQUIRE(buf[0] == 3);
+	REQUIRE(buf[2] == 5);
+
+	buf.clear();
+	buf.reset_counters();
+	buf.set_depth_limits(2, 6);
+
+	/* One command per step: no jitter, so the depth stays at the minimum. */
+	for (int i = 0; i < 100; ++i) {
+		buf.push(i);
+		buf.begin_step();
+		buf.pop_front(1);
+	}
+
+	REQUIRE(buf.get_target_depth() == 2);
+	REQUIRE(buf.get_stats().steps_extrapolated == 0);
+
+	/* Commands come in bursts of four, with three empty steps in between. */
+	for (int i = 0; i < 400; ++i) {
+		if (i % 4 == 0) {
+			for (int j = 0; j < 4; ++j) {
+				buf.push(j);
+			}
+		}
+
+		buf.begin_step();
+		buf.pop_front(1);
+	}
+
+	REQUIRE(buf.get_target_depth() >= 4);
+	REQUIRE(buf.get_stats().overflows == 0);
+	REQUIRE(buf.get_stats().steps_extrapolated == 0);
+
+	buf.set_depth_limits(2, 3);
+	REQUIRE(buf.get_target_depth() == 3);
+}
+#endif
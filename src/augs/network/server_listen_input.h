@@ -1,7 +1,9 @@
 #pragma once
 #include <string>
+#include <vector>
 #include "augs/templates/maybe.h"
 #include "augs/network/port_type.h"
+#include "augs/network/network_types.h"
 
 namespace augs {
 	struct server_listen_input {
@@ -15,6 +17,7 @@ namespace augs {
 	struct dedicated_server_input {
 		// GEN INTROSPECTOR struct augs::dedicated_server_input
 		bool dummy = false;
+		std::vector<arena_identifier> additional_arenas;
 		// END GEN INTROSPECTOR
 	};
 }
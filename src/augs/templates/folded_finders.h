@@ -36,6 +36,16 @@ template <template <class> class Criterion, class List>
 constexpr bool all_in_list_are_v = all_in_list_are<Criterion, List>::value;
 
 
+template <class A, class B>
+struct lists_intersect;
+
+template <template <class...> class L, class... Types, class B>
+struct lists_intersect<L<Types...>, B> : std::bool_constant<(false || ... || is_one_of_list_v<Types, B>)> {};
+
+template <class A, class B>
+constexpr bool lists_intersect_v = lists_intersect<A, B>::value;
+
+
 template <std::size_t i, class Candidate, class List>
 struct index_in_list;
 
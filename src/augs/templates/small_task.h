@@ -0,0 +1,138 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace augs {
+	/*
+		A move-only, type-erased void() callable.
+		Callables that fit into the inline buffer are never allocated on the heap,
+		which covers all the reference-capturing lambdas posted each frame.
+	*/
+
+	template <std::size_t inline_capacity>
+	class small_task {
+		using storage_type = std::aligned_storage_t<inline_capacity, alignof(std::max_align_t)>;
+
+		enum class operation {
+			MOVE,
+			DESTROY
+		};
+
+		using invoke_type = void(*)(void*);
+		using manage_type = void(*)(operation, void* self, void* other);
+
+		storage_type storage;
+		invoke_type invoker = nullptr;
+		manage_type manager = nullptr;
+
+		template <class F>
+		static constexpr bool fits_inline_v =
+			sizeof(F) <= inline_capacity
+			&& alignof(F) <= alignof(std::max_align_t)
+			&& std::is_nothrow_move_constructible_v<F>
+		;
+
+		template <class F>
+		static void invoke_inline(void* s) {
+			(*std::launder(reinterpret_cast<F*>(s)))();
+		}
+
+		template <class F>
+		static void invoke_heap(void* s) {
+			(**std::launder(reinterpret_cast<F**>(s)))();
+		}
+
+		template <class F>
+		static void manage_inline(const operation op, void* const self, void* const other) {
+			auto& f = *std::launder(reinterpret_cast<F*>(self));
+
+			if (op == operation::MOVE) {
+				new (other) F(std::move(f));
+			}
+
+			f.~F();
+		}
+
+		template <class F>
+		static void manage_heap(const operation op, void* const self, void* const other) {
+			auto& f = *std::launder(reinterpret_cast<F**>(self));
+
+			if (op == operation::MOVE) {
+				new (other) F*(f);
+			}
+			else {
+				delete f;
+			}
+		}
+
+		void reset() {
+			if (manager != nullptr) {
+				manager(operation::DESTROY, &storage, nullptr);
+			}
+
+			invoker = nullptr;
+			manager = nullptr;
+		}
+
+		void steal(small_task& b) noexcept {
+			if (b.manager != nullptr) {
+				b.manager(operation::MOVE, &b.storage, &storage);
+			}
+
+			invoker = b.invoker;
+			manager = b.manager;
+
+			b.invoker = nullptr;
+			b.manager = nullptr;
+		}
+
+	public:
+		small_task() = default;
+
+		template <class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, small_task>>>
+		small_task(F&& callable) {
+			using T = std::decay_t<F>;
+
+			if constexpr(fits_inline_v<T>) {
+				new (&storage) T(std::forward<F>(callable));
+				invoker = &invoke_inline<T>;
+				manager = &manage_inline<T>;
+			}
+			else {
+				new (&storage) T*(new T(std::forward<F>(callable)));
+				invoker = &invoke_heap<T>;
+				manager = &manage_heap<T>;
+			}
+		}
+
+		small_task(small_task&& b) noexcept {
+			steal(b);
+		}
+
+		small_task& operator=(small_task&& b) noexcept {
+			if (this != &b) {
+				reset();
+				steal(b);
+			}
+
+			return *this;
+		}
+
+		small_task(const small_task&) = delete;
+		small_task& operator=(const small_task&) = delete;
+
+		~small_task() {
+			reset();
+		}
+
+		void operator()() {
+			invoker(&storage);
+		}
+
+		explicit operator bool() const {
+			return invoker != nullptr;
+		}
+	};
+}
@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <iterator>
+
+#include "augs/ensure.h"
+#include "augs/ensure_rel.h"
+#include "augs/misc/compress.h"
+#include "augs/templates/snapshot_chain.h"
+
+namespace augs {
+	static void xor_with(std::vector<std::byte>& target, const std::vector<std::byte>& base) {
+		const auto common = std::min(target.size(), base.size());
+
+		std::byte* const t = target.data();
+		const std::byte* const b = base.data();
+
+		for (std::size_t i = 0; i < common; ++i) {
+			t[i] ^= b[i];
+		}
+	}
+
+	snapshot_chain::step_type snapshot_chain::get_latest_keyframe_step() const {
+		ensure(!entries.empty());
+
+		/* The last snapshot is either the latest keyframe or a delta against it. */
+		return entries.rbegin()->second.keyframe_step;
+	}
+
+	const std::vector<std::byte>& snapshot_chain::get_keyframe(const step_type step) {
+		if (cached_keyframe_step != step) {
+			const auto& keyframe = entries.at(step);
+			ensure_eq(step, keyframe.keyframe_step);
+
+			cached_keyframe_step.reset();
+			cached_keyframe.resize(keyframe.uncompressed_size);
+
+			if (keyframe.uncompressed_size > 0) {
+				decompress(keyframe.compressed, cached_keyframe);
+			}
+
+			cached_keyframe_step = step;
+		}
+
+		return cached_keyframe;
+	}
+
+	void snapshot_chain::push(
+		const step_type step,
+		const std::vector<std::byte>& snapshot,
+		const snapshotted_player_settings& settings
+	) {
+		if (compression_state.empty()) {
+			compression_state = make_compression_state();
+		}
+
+		/* Replaces the snapshot at this step and everything after it. */
+		entries.erase(entries.lower_bound(step), entries.end());
+
+		if (cached_keyframe_step.has_value() && *cached_keyframe_step >= step) {
+			cached_keyframe_step.reset();
+		}
+
+		stored_snapshot entry;
+		entry.uncompressed_size = static_cast<uint32_t>(snapshot.size());
+
+		const auto keyframe_interval = settings.snapshot_keyframe_interval;
+
+		bool as_keyframe = entries.empty() || keyframe_interval <= 1;
+
+		if (!as_keyframe) {
+			const auto keyframe_step = get_latest_keyframe_step();
+			const auto deltas_since_keyframe = static_cast<std::size_t>(std::distance(entries.find(keyframe_step), entries.end())) - 1;
+
+			as_keyframe = deltas_since_keyframe + 1 >= keyframe_interval;
+
+			if (!as_keyframe) {
+				encoding_buffer.assign(snapshot.begin(), snapshot.end());
+				xor_with(encoding_buffer, get_keyframe(keyframe_step));
+
+				compress(compression_state, encoding_buffer, entry.compressed);
+
+				/* Not worth the extra decompression on seek. */
+				const auto keyframe_bytes = entries.at(keyframe_step).compressed.size();
+				as_keyframe = entry.compressed.size() * 2 > keyframe_bytes;
+
+				entry.keyframe_step = keyframe_step;
+			}
+		}
+
+		if (as_keyframe) {
+			entry.keyframe_step = step;
+			entry.compressed.clear();
+
+			if (!snapshot.empty()) {
+				compress(compression_state, snapshot, entry.compressed);
+			}
+
+			cached_keyframe = snapshot;
+			cached_keyframe_step = step;
+		}
+
+		entries.emplace(step, std::move(entry));
+
+		if (settings.max_snapshots_memory_mb > 0) {
+			thin_out(static_cast<std::size_t>(settings.max_snapshots_memory_mb) * 1024 * 1024);
+		}
+	}
+
+	void snapshot_chain::thin_out(const std::size_t budget_bytes) {
+		auto total = get_stored_bytes();
+
+		while (total > budget_bytes && entries.size() > 2) {
+			const auto first = entries.begin();
+			const auto last = std::prev(entries.end());
+
+			auto is_delta = [](const auto& it) {
+				return it->second.keyframe_step != it->first;
+			};
+
+			auto victim = entries.end();
+
+			for (auto it = std::next(first); it != last; ++it) {
+				if (is_delta(it)) {
+					victim = it;
+					break;
+				}
+			}
+
+			if (victim == entries.end()) {
+				/*
+					Only the last snapshot might still be a delta,
+					so every keyframe but the one it depends on is free to go.
+				*/
+
+				const auto latest_keyframe = get_latest_keyframe_step();
+
+				for (auto it = std::next(first); it != last; ++it) {
+					if (it->first != latest_keyframe) {
+						victim = it;
+						break;
+					}
+				}
+			}
+
+			if (victim == entries.end()) {
+				break;
+			}
+
+			if (cached_keyframe_step == victim->first) {
+				cached_keyframe_step.reset();
+			}
+
+			total -= victim->second.compressed.size();
+			entries.erase(victim);
+		}
+	}
+
+	void snapshot_chain::decode(const step_type step, std::vector<std::byte>& output) {
+		const auto& entry = entries.at(step);
+
+		if (entry.keyframe_step == step) {
+			output = get_keyframe(step);
+			return;
+		}
+
+		output.resize(entry.uncompressed_size);
+
+		if (entry.uncompressed_size > 0) {
+			decompress(entry.compressed, output);
+		}
+
+		xor_with(output, get_keyframe(entry.keyframe_step));
+	}
+
+	std::optional<snapshot_chain::step_type> snapshot_chain::find_at_or_before(const step_type step) const {
+		auto it = entries.upper_bound(step);
+
+		if (it == entries.begin()) {
+			return std::nullopt;
+		}
+
+		return std::prev(it)->first;
+	}
+
+	void snapshot_chain::erase_after(const step_type step) {
+		entries.erase(entries.upper_bound(step), entries.end());
+
+		if (cached_keyframe_step.has_value() && *cached_keyframe_step > step) {
+			cached_keyframe_step.reset();
+		}
+	}
+
+	void snapshot_chain::clear() {
+		entries.clear();
+		cached_keyframe_step.reset();
+	}
+
+	bool snapshot_chain::contains(const step_type step) const {
+		return entries.find(step) != entries.end();
+	}
+
+	bool snapshot_chain::empty() const {
+		return entries.empty();
+	}
+
+	std::size_t snapshot_chain::size() const {
+		return entries.size();
+	}
+
+	std::size_t snapshot_chain::count_keyframes() const {
+		return static_cast<std::size_t>(std::count_if(entries.begin(), entries.end(), [](const auto& e) {
+			return e.first == e.second.keyframe_step;
+		}));
+	}
+
+	std::size_t snapshot_chain::index_of(const step_type step) const {
+		return static_cast<std::size_t>(std::distance(entries.begin(), entries.lower_bound(step)));
+	}
+
+	std::size_t snapshot_chain::get_stored_bytes() const {
+		std::size_t total = 0;
+
+		for (const auto& e : entries) {
+			total += e.second.compressed.size();
+		}
+
+		return total;
+	}
+
+	std::size_t snapshot_chain::get_uncompressed_bytes() const {
+		std::size_t total = 0;
+
+		for (const auto& e : entries) {
+			total += e.second.uncompressed_size;
+		}
+
+		return total;
+	}
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("SnapshotChain DeltasAndBudget") {
+	using namespace augs;
+
+	/* Incompressible by itself, but each snapshot only slightly differs from the previous one. */
+
+	uint32_t seed = 1337;
+
+	auto next_random = [&seed]() {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return seed;
+	};
+
+	std::vector<std::byte> current(256 * 1024);
+
+	for (auto& b : current) {
+		b = static_cast<std::byte>(next_random());
+	}
+
+	auto mutate = [&]() {
+		for (int i = 0; i < 100; ++i) {
+			current[next_random() % current.size()] = static_cast<std::byte>(next_random());
+		}
+
+		/* Snapshots might also change their size. */
+		current.resize(current.size() + next_random() % 64);
+	};
+
+	std::map<snapshot_chain::step_type, std::vector<std::byte>> originals;
+
+	auto check_all = [&](snapshot_chain& chain) {
+		std::vector<std::byte> decoded;
+
+		for (const auto& o : originals) {
+			if (chain.contains(o.first)) {
+				chain.decode(o.first, decoded);
+				REQUIRE(decoded == o.second);
+			}
+		}
+	};
+
+	{
+		snapshotted_player_settings settings;
+		settings.snapshot_keyframe_interval = 8;
+		settings.max_snapshots_memory_mb = 0;
+
+		snapshot_chain chain;
+
+		chain.push(0, {}, settings);
+		originals[0] = {};
+
+		for (snapshot_chain::step_type step = 100; step <= 3200; step += 100) {
+			mutate();
+			chain.push(step, current, settings);
+			originals[step] = current;
+		}
+
+		REQUIRE(chain.size() == originals.size());
+		REQUIRE(chain.count_keyframes() < chain.size() / 4);
+		REQUIRE(chain.get_stored_bytes() < chain.get_uncompressed_bytes() / 4);
+
+		check_all(chain);
+
+		REQUIRE(chain.find_at_or_before(150) == 100u);
+		REQUIRE(chain.find_at_or_before(3200) == 3200u);
+
+		/* Rewinding and recording anew. */
+		chain.erase_after(1000);
+		REQUIRE(chain.size() == 11);
+
+		mutate();
+		chain.push(1050, current, settings);
+		originals[1050] = current;
+
+		check_all(chain);
+	}
+
+	{
+		snapshotted_player_settings settings;
+		settings.snapshot_keyframe_interval = 2;
+		settings.max_snapshots_memory_mb = 1;
+
+		snapshot_chain chain;
+		originals.clear();
+
+		chain.push(0, {}, settings);
+		originals[0] = {};
+
+		const snapshot_chain::step_type last_step = 4000;
+
+		for (snapshot_chain::step_type step = 100; step <= last_step; step += 100) {
+			mutate();
+			chain.push(step, current, settings);
+			originals[step] = current;
+
+			REQUIRE(chain.get_stored_bytes() <= 1024 * 1024 + current.size());
+		}
+
+		REQUIRE(chain.size() < originals.size());
+		REQUIRE(chain.contains(0));
+		REQUIRE(chain.contains(last_step));
+		REQUIRE(chain.find_at_or_before(last_step - 1).has_value());
+
+		check_all(chain);
+	}
+}
+#endif
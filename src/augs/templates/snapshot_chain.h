@@ -0,0 +1,87 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "augs/templates/snapshotted_player_step_type.h"
+#include "augs/templates/snapshotted_player_settings.h"
+
+namespace augs {
+	struct introspection_access;
+
+	struct stored_snapshot {
+		using step_type = snapshotted_player_step_type;
+
+		// GEN INTROSPECTOR struct augs::stored_snapshot
+		step_type keyframe_step = 0;
+		uint32_t uncompressed_size = 0;
+		std::vector<std::byte> compressed;
+		// END GEN INTROSPECTOR
+	};
+
+	/*
+		Serialized snapshots, kept in memory as compactly as possible.
+
+		Every few snapshots there is a keyframe, which is just the compressed snapshot.
+		Every other snapshot is XORed against its keyframe and then compressed.
+		Consecutive snapshots share most of their bytes, so the XOR is mostly zeros,
+		which compresses far better than the snapshot itself.
+		A delta turns into a keyframe if it would not save enough.
+
+		Decoding never needs more than the snapshot and its keyframe.
+
+		Past the memory budget, the oldest deltas are dropped first,
+		then the oldest keyframes, but never the very first snapshot.
+	*/
+
+	class snapshot_chain {
+	public:
+		using step_type = snapshotted_player_step_type;
+
+	private:
+		friend introspection_access;
+
+		// GEN INTROSPECTOR class augs::snapshot_chain
+		std::map<step_type, stored_snapshot> entries;
+		// END GEN INTROSPECTOR
+
+		std::vector<std::byte> compression_state;
+
+		std::optional<step_type> cached_keyframe_step;
+		std::vector<std::byte> cached_keyframe;
+		std::vector<std::byte> encoding_buffer;
+
+		step_type get_latest_keyframe_step() const;
+		const std::vector<std::byte>& get_keyframe(step_type);
+
+		void thin_out(std::size_t budget_bytes);
+
+	public:
+		void push(
+			step_type step,
+			const std::vector<std::byte>& snapshot,
+			const snapshotted_player_settings& settings
+		);
+
+		/* Throws decompression_error if the chain is corrupt. */
+		void decode(step_type step, std::vector<std::byte>& output);
+
+		/* The step of the latest snapshot that is not later than the given one. */
+		std::optional<step_type> find_at_or_before(step_type) const;
+
+		void erase_after(step_type);
+		void clear();
+
+		bool contains(step_type) const;
+		bool empty() const;
+
+		std::size_t size() const;
+		std::size_t count_keyframes() const;
+		std::size_t index_of(step_type) const;
+
+		std::size_t get_stored_bytes() const;
+		std::size_t get_uncompressed_bytes() const;
+	};
+}
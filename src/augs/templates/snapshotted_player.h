@@ -1,10 +1,14 @@
 #pragma once
 #include <map>
+#include <vector>
+#include <cstddef>
+#include <type_traits>
 #include "augs/misc/timing/stepped_timing.h"
 #include "augs/misc/timing/fixed_delta_timer.h"
 #include "augs/misc/timing/delta.h"
 #include "augs/templates/snapshotted_player_step_type.h"
 #include "augs/templates/snapshotted_player_settings.h"
+#include "augs/templates/snapshot_chain.h"
 
 namespace augs {
 	struct introspection_access;
@@ -34,6 +38,11 @@ namespace augs {
 		class snapshot_type
 	>
 	class snapshotted_player {
+		static_assert(
+			std::is_same_v<snapshot_type, std::vector<std::byte>>,
+			"Snapshots are kept as delta-compressed bytes, so they must be serialized."
+		);
+
 	public: 
 		using step_type = snapshotted_player_step_type;
 		using step_to_entropy_type = std::map<step_type, entropy_type>;
@@ -47,7 +56,7 @@ namespace augs {
 		};
 
 		friend introspection_access;
-		using snapshots_type = std::map<step_type, snapshot_type>;
+		using snapshots_type = snapshot_chain;
 
 		// GEN INTROSPECTOR class augs::snapshotted_player class A class B
 		step_to_entropy_type step_to_entropy;
@@ -62,8 +71,10 @@ namespace augs {
 		step_type additional_steps = 0;
 		// END GEN INTROSPECTOR
 
+		snapshot_type decoded_snapshot;
+
 		template <class GenerateSnapshot>
-		void push_snapshot_if_needed(GenerateSnapshot&&, unsigned interval_in_steps);
+		void push_snapshot_if_needed(GenerateSnapshot&&, const snapshotted_player_settings&);
 
 		template <class I>
 		void advance_single_step(const I& input);
@@ -141,13 +141,13 @@ namespace augs {
 
 		PLR_LOG("Seeking from %x to %x", current_step, seeked_step);
 
-		const auto& seeked_adj_snapshot = *std::prev(snapshots.upper_bound(seeked_step)); 
-		const auto step_of_adj_snapshot = seeked_adj_snapshot.first;
+		const auto step_of_adj_snapshot = *snapshots.find_at_or_before(seeked_step);
 	   
 		auto seek_to_snapshot = [&]() {
 			PLR_LOG("Set snapshot at step %x (size: %x)", current_step, snapshots.size());
 
-			load_snapshot(step_of_adj_snapshot, seeked_adj_snapshot.second);
+			snapshots.decode(step_of_adj_snapshot, decoded_snapshot);
+			load_snapshot(step_of_adj_snapshot, decoded_snapshot);
 
 			current_step = step_of_adj_snapshot;
 		};
@@ -186,7 +186,9 @@ namespace augs {
 
 	template <class A, class B>
 	template <class GenerateSnapshot>
-	void snapshotted_player<A, B>::push_snapshot_if_needed(GenerateSnapshot&& generate_snapshot, const unsigned interval_in_steps) {
+	void snapshotted_player<A, B>::push_snapshot_if_needed(GenerateSnapshot&& generate_snapshot, const snapshotted_player_settings& settings) {
+		const auto interval_in_steps = settings.snapshot_interval_in_steps;
+
 		if (is_recording() || (is_replaying() && get_current_step() == 0)) {
 			const bool is_snapshot_time = [&]() {
 				if (snapshots.empty()) {
@@ -198,19 +200,17 @@ namespace augs {
 					return false;
 				}
 
-				const auto& it = *std::prev(snapshots.upper_bound(current_step));
-
-				const auto since_last = current_step - it.first;
+				const auto since_last = current_step - *snapshots.find_at_or_before(current_step);
 				return since_last >= interval_in_steps;
 			}();
 
 			if (is_snapshot_time) {
 				PLR_LOG("Snapshot step: %x. Pushed.", current_step);
-				snapshots[current_step] = generate_snapshot(current_step);
+				snapshots.push(current_step, generate_snapshot(current_step), settings);
 			}
 		}
 		else {
-			const bool valid_snapshot_exists = found_in(snapshots, current_step);
+			const bool valid_snapshot_exists = snapshots.contains(current_step);
 
 			if (valid_snapshot_exists) {
 				PLR_LOG("Snapshot step: %x. Exists.", current_step);
@@ -223,7 +223,7 @@ namespace augs {
 	template <class entropy_type, class B>
 	template <class I>
 	void snapshotted_player<entropy_type, B>::advance_single_step(const I& in) {
-		push_snapshot_if_needed(in.generate_snapshot, in.settings.snapshot_interval_in_steps);
+		push_snapshot_if_needed(in.generate_snapshot, in.settings);
 
 		auto considered_mode = advance_mode;
 
@@ -250,10 +250,7 @@ namespace augs {
 					}
 				}
 
-				snapshots.erase(
-					snapshots.upper_bound(current_step),
-					snapshots.end()
-				);
+				snapshots.erase_after(current_step);
 		
 				break;
 
@@ -4,6 +4,8 @@ namespace augs {
 	struct snapshotted_player_settings {
 		// GEN INTROSPECTOR struct augs::snapshotted_player_settings
 		unsigned snapshot_interval_in_steps = 800;
+		unsigned snapshot_keyframe_interval = 8;
+		unsigned max_snapshots_memory_mb = 512;
 		// END GEN INTROSPECTOR
 	};
 }
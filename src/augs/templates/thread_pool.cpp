@@ -0,0 +1,60 @@
+#if BUILD_UNIT_TESTS
+#include <array>
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/log.h"
+#include "augs/misc/timing/timer.h"
+#include "augs/templates/thread_pool.h"
+
+TEST_CASE("ThreadPool AllTasksCompleteInEachBatch") {
+	for (const auto num_workers : { 0, 1, 8, 32 }) {
+		augs::thread_pool pool(num_workers);
+
+		std::atomic<int> sum = 0;
+
+		for (int batch = 0; batch < 50; ++batch) {
+			for (int i = 0; i < 100; ++i) {
+				pool.enqueue([&sum, i]() { sum += i; });
+			}
+
+			/* Too big to be stored inline. */
+			std::array<int, 64> big_capture {};
+			big_capture[0] = 1;
+
+			pool.enqueue([&sum, big_capture]() { sum += big_capture[0]; });
+
+			pool.submit();
+			pool.help_until_no_tasks();
+			pool.wait_for_all_tasks_to_complete();
+
+			REQUIRE(sum.load() == (batch + 1) * (4950 + 1));
+		}
+	}
+}
+
+TEST_CASE("ThreadPool DispatchOverhead", "[.bench]") {
+	constexpr int num_batches = 1000;
+	constexpr int tasks_per_batch = 100;
+
+	for (const auto num_workers : { 1, 8, 32 }) {
+		augs::thread_pool pool(num_workers);
+
+		std::atomic<int> counter = 0;
+		augs::timer tm;
+
+		for (int batch = 0; batch < num_batches; ++batch) {
+			for (int i = 0; i < tasks_per_batch; ++i) {
+				pool.enqueue([&counter]() { ++counter; });
+			}
+
+			pool.submit();
+			pool.help_until_no_tasks();
+			pool.wait_for_all_tasks_to_complete();
+		}
+
+		const auto us_per_task = tm.get<std::chrono::microseconds>() / (num_batches * tasks_per_batch);
+
+		LOG("Thread pool with %x workers: %x us per dispatched task.", num_workers, us_per_task);
+		REQUIRE(counter.load() == num_batches * tasks_per_batch);
+	}
+}
+#endif
@@ -1,18 +1,61 @@
 #pragma once
 #include <vector>
+#include <memory>
+#include <algorithm>
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <cstdint>
 #include <condition_variable>
-#include <functional>
+
+#include "augs/ensure.h"
+#include "augs/templates/small_task.h"
 
 namespace augs {
+	/*
+		Tasks are enqueued on one thread and then published all at once by submit().
+		Each worker owns a contiguous range of the published batch
+		and pops from its back, while idle workers and helping threads steal from the front of other ranges.
+
+		A range is a single atomic word, so both popping and stealing are a single compare-and-swap.
+		The word is tagged with the batch number so that a stale thief can never take a task from a newer batch.
+	*/
+
 	class thread_pool {
+		using task_type = small_task<64>;
+		using range_type = uint64_t;
+
+		static constexpr unsigned index_bits = 24;
+		static constexpr range_type index_mask = (range_type(1) << index_bits) - 1;
+		static constexpr range_type batch_mask = (range_type(1) << (64 - 2 * index_bits)) - 1;
+
+		static range_type make_range(const range_type batch, const range_type first, const range_type last) {
+			return ((batch & batch_mask) << (2 * index_bits)) | (first << index_bits) | last;
+		}
+
+		static auto get_first(const range_type r) {
+			return static_cast<std::size_t>((r >> index_bits) & index_mask);
+		}
+
+		static auto get_last(const range_type r) {
+			return static_cast<std::size_t>(r & index_mask);
+		}
+
+		struct alignas(64) task_range {
+			std::atomic<range_type> range = 0;
+		};
+
 		std::vector<std::thread> workers;
-		std::vector<std::function<void()>> tasks;
-		std::vector<std::function<void()>> cold_tasks;
+		std::unique_ptr<task_range[]> ranges;
+		std::size_t num_ranges = 0;
+
+		std::vector<task_type> tasks;
+		std::vector<task_type> cold_tasks;
 
-		int tasks_completed = 0;
+		std::atomic<int> tasks_remaining = 0;
+		std::atomic<unsigned> next_victim = 0;
+
+		range_type current_batch = 0;
 		int tasks_posted = 0;
 
 		std::mutex queue_mutex;
@@ -32,35 +75,104 @@ namespace augs {
 		}
 
 		void register_completion() {
-			{
-				auto lock = lock_completion();
-				++tasks_completed;
+			if (tasks_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				{
+					/* Prevents the notification from slipping between the waiter's check and its sleep. */
+					auto lock = lock_completion();
+				}
 
-				if (tasks_completed == tasks_posted) {
-					completion_variable.notify_all();
+				completion_variable.notify_all();
+			}
+		}
+
+		bool pop_back(task_range& from, std::size_t& result) {
+			auto r = from.range.load(std::memory_order_acquire);
+
+			for (;;) {
+				const auto first = get_first(r);
+				const auto last = get_last(r);
+
+				if (first >= last) {
+					return false;
+				}
+
+				const auto batch = r >> (2 * index_bits);
+
+				if (from.range.compare_exchange_weak(r, make_range(batch, first, last - 1), std::memory_order_acq_rel)) {
+					result = last - 1;
+					return true;
 				}
 			}
 		}
 
-		auto make_continuous_worker() {
-			return [this] {
-				for (;;) {
-					std::function<void()> task;
+		bool steal_front(task_range& from, std::size_t& result) {
+			auto r = from.range.load(std::memory_order_acquire);
+
+			for (;;) {
+				const auto first = get_first(r);
+				const auto last = get_last(r);
 
+				if (first >= last) {
+					return false;
+				}
+
+				const auto batch = r >> (2 * index_bits);
+
+				if (from.range.compare_exchange_weak(r, make_range(batch, first + 1, last), std::memory_order_acq_rel)) {
+					result = first;
+					return true;
+				}
+			}
+		}
+
+		bool try_steal(std::size_t& result) {
+			const auto n = num_ranges;
+			const auto start = next_victim.fetch_add(1, std::memory_order_relaxed);
+
+			for (std::size_t i = 0; i < n; ++i) {
+				if (steal_front(ranges[(start + i) % n], result)) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void run(const std::size_t task_index) {
+			tasks[task_index]();
+			register_completion();
+		}
+
+		void work_until_no_tasks(const std::size_t own_range) {
+			std::size_t task_index = 0;
+
+			for (;;) {
+				if (pop_back(ranges[own_range], task_index) || try_steal(task_index)) {
+					run(task_index);
+				}
+				else {
+					return;
+				}
+			}
+		}
+
+		auto make_continuous_worker(const std::size_t own_range) {
+			return [this, own_range] {
+				range_type last_seen_batch = 0;
+
+				for (;;) {
 					{
 						auto lock = lock_queue();
-						cv.wait(lock, [this]{ return shall_quit || !tasks.empty(); });
+						cv.wait(lock, [&]{ return shall_quit || current_batch != last_seen_batch; });
 
-						if (shall_quit.load() && tasks.empty()) {
+						if (shall_quit.load()) {
 							return;
 						}
 
-						task = std::move(tasks.back());
-						tasks.pop_back();
+						last_seen_batch = current_batch;
 					}
 
-					task();
-					register_completion();
+					work_until_no_tasks(own_range);
 				}
 			};
 		}
@@ -76,7 +188,11 @@ namespace augs {
 				return;
 			}
 
-			shall_quit.store(true);
+			{
+				auto lock = lock_queue();
+				shall_quit.store(true);
+			}
+
 			cv.notify_all();
 			join_all();
 			workers.clear();
@@ -95,26 +211,44 @@ namespace augs {
 			quit_all_workers();
 			shall_quit.store(false);
 
+			/* Without workers, the helping threads still need a range to take tasks from. */
+			num_ranges = std::max(num_workers, std::size_t(1));
+			ranges = std::make_unique<task_range[]>(num_ranges);
+
 			for (std::size_t i = 0; i < num_workers; ++i) {
-				workers.emplace_back(make_continuous_worker());
+				workers.emplace_back(make_continuous_worker(i));
 			}
 		}
 
 		template <class F>
 		void enqueue(F&& f) {
-			cold_tasks.emplace_back(std::move(f));
+			cold_tasks.emplace_back(std::forward<F>(f));
 		}
 
 		void submit() {
+			ensure(tasks_remaining.load() == 0);
+			ensure(cold_tasks.size() <= index_mask);
+
+			const auto n = cold_tasks.size();
+
 			{
 				auto lock = lock_queue();
-				ensure(tasks.empty());
+
 				std::swap(cold_tasks, tasks);
+				++current_batch;
+
+				tasks_remaining.store(static_cast<int>(n));
+
+				for (std::size_t i = 0; i < num_ranges; ++i) {
+					const auto first = n * i / num_ranges;
+					const auto last = n * (i + 1) / num_ranges;
+
+					ranges[i].range.store(make_range(current_batch, first, last), std::memory_order_release);
+				}
 
 				{
 					auto lock = lock_completion();
-					tasks_completed = 0;
-					tasks_posted = tasks.size();
+					tasks_posted = static_cast<int>(n);
 				}
 			}
 
@@ -133,29 +267,20 @@ namespace augs {
 		}
 
 		void help_until_no_tasks() {
-			for (;;) {
-				std::function<void()> task;
+			std::size_t task_index = 0;
 
-				{
-					auto lock = lock_queue();
-
-					if (tasks.empty()) {
-						return;
-					}
-
-					task = std::move(tasks.back());
-					tasks.pop_back();
-				}
-
-				task();
-				register_completion();
+			while (try_steal(task_index)) {
+				run(task_index);
 			}
 		}
 
 		void wait_for_all_tasks_to_complete() {
+			if (tasks_remaining.load(std::memory_order_acquire) == 0) {
+				return;
+			}
+
 			auto lock = lock_completion();
-			completion_variable.wait(lock, [this]{ return tasks_posted == tasks_completed; });
+			completion_variable.wait(lock, [this]{ return tasks_remaining.load(std::memory_order_acquire) == 0; });
 		}
 	};
 }
-
@@ -11,6 +11,11 @@ struct atlas_profiler : public augs::profiler_mixin<atlas_profiler> {
 	augs::time_measurements gathering_subjects = std::size_t(1);
 	augs::time_measurements unpacking_results = std::size_t(1);
 
+	augs::time_measurements calculating_cache_key = std::size_t(1);
+	augs::time_measurements cache_hit = std::size_t(1);
+	augs::time_measurements cache_miss = std::size_t(1);
+	augs::time_measurements saving_to_cache = std::size_t(1);
+
 	augs::time_measurements loading_image_sizes = std::size_t(1);
 	augs::time_measurements loading_images = std::size_t(1);
 	augs::time_measurements making_worker_inputs = std::size_t(1);
@@ -0,0 +1,256 @@
+#include <algorithm>
+
+#include "augs/log.h"
+#include "augs/misc/compress.h"
+#include "augs/misc/secure_hash.h"
+#include "augs/misc/measurements.h"
+
+#include "augs/readwrite/memory_stream.h"
+#include "augs/readwrite/byte_file.h"
+#include "augs/filesystem/directory.h"
+
+#include "augs/texture_atlas/cached_atlas.h"
+
+/* Bump whenever the layout of baked_atlas or the format of the cached file changes. */
+static constexpr uint32_t atlas_cache_version = 1;
+
+static const auto cached_atlas_extension = std::string(".atlas");
+
+static void write_file_hash(
+	augs::memory_stream& key,
+	const augs::path_type& path,
+	std::vector<std::byte>& file_bytes
+) {
+	try {
+		augs::file_to_bytes(path, file_bytes);
+
+		augs::write_bytes(key, true);
+		augs::write_bytes(key, augs::secure_hash(file_bytes));
+	}
+	catch (...) {
+		/* Missing files bake into a glitched entry, so they too have to be a part of the key. */
+		augs::write_bytes(key, false);
+	}
+}
+
+static augs::secure_hash_type calc_cache_key(const bake_fresh_atlas_input in) {
+	const auto& subjects = in.subjects;
+
+	thread_local std::vector<std::byte> file_bytes;
+	auto key = augs::memory_stream();
+
+	augs::write_bytes(key, atlas_cache_version);
+	augs::write_bytes(key, in.max_atlas_size);
+
+	augs::write_bytes(key, subjects.images.size());
+
+	for (const auto& path : subjects.images) {
+		augs::write_bytes(key, path);
+		write_file_hash(key, path, file_bytes);
+	}
+
+	augs::write_bytes(key, subjects.loaded_images.size());
+
+	for (const auto& bytes : subjects.loaded_images) {
+		augs::write_bytes(key, augs::secure_hash(bytes));
+	}
+
+	augs::write_bytes(key, subjects.fonts.size());
+
+	for (const auto& font : subjects.fonts) {
+		augs::write_bytes(key, font);
+		augs::write_bytes(key, augs::_should(font.add_japanese_ranges));
+		augs::write_bytes(key, augs::_should(font.add_cyrillic_ranges));
+
+		write_file_hash(key, font.source_font_path, file_bytes);
+	}
+
+	return augs::secure_hash(key.data(), key.size());
+}
+
+static rgba* get_output_pixels(const bake_fresh_atlas_output out) {
+	const auto size = out.baked.atlas_image_size;
+
+	if (out.whole_image != nullptr) {
+		return out.whole_image;
+	}
+
+	out.fallback_output.resize(size.area());
+	return out.fallback_output.data();
+}
+
+static bool try_load_cached_atlas(
+	const augs::path_type& path,
+	const bake_fresh_atlas_input in,
+	const bake_fresh_atlas_output out
+) {
+	if (!augs::exists(path)) {
+		return false;
+	}
+
+	thread_local std::vector<std::byte> file_bytes;
+
+	auto& baked = out.baked;
+
+	try {
+		augs::file_to_bytes(path, file_bytes);
+
+		auto s = augs::cref_memory_stream(file_bytes);
+
+		if (augs::read_bytes<uint32_t>(s) != atlas_cache_version) {
+			return false;
+		}
+
+		augs::read_bytes(s, baked.atlas_image_size);
+		augs::read_bytes(s, baked.images);
+		augs::read_bytes(s, baked.fonts);
+		augs::read_bytes(s, baked.loaded_images);
+
+		const auto size = baked.atlas_image_size;
+
+		if (size.x > in.max_atlas_size || size.y > in.max_atlas_size) {
+			throw augs::stream_read_error("Cached atlas size (%x) exceeds the max atlas size (%x).", size, in.max_atlas_size);
+		}
+
+		const auto compressed_pos = s.get_read_pos();
+
+		augs::decompress(
+			file_bytes.data() + compressed_pos,
+			file_bytes.size() - compressed_pos,
+			reinterpret_cast<std::byte*>(get_output_pixels(out)),
+			std::size_t(size.area()) * sizeof(rgba)
+		);
+	}
+	catch (const std::exception& err) {
+		LOG("Failed to load the cached atlas from %x: %x. Baking a fresh one.", path, err.what());
+
+		baked.clear();
+		baked.loaded_images.clear();
+
+		augs::remove_file(path);
+		return false;
+	}
+
+	/* Mark as recently used. */
+	std::error_code err;
+	std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), err);
+
+	return true;
+}
+
+static void save_atlas_to_cache(
+	const augs::path_type& path,
+	const bake_fresh_atlas_output out
+) {
+	thread_local std::vector<std::byte> file_bytes;
+	thread_local auto compression_state = augs::make_compression_state();
+
+	const auto& baked = out.baked;
+
+	file_bytes.clear();
+
+	{
+		auto s = augs::ref_memory_stream(file_bytes);
+
+		augs::write_bytes(s, atlas_cache_version);
+		augs::write_bytes(s, baked.atlas_image_size);
+		augs::write_bytes(s, baked.images);
+		augs::write_bytes(s, baked.fonts);
+		augs::write_bytes(s, baked.loaded_images);
+	}
+
+	const auto* const pixels = out.whole_image != nullptr ? out.whole_image : out.fallback_output.data();
+
+	augs::compress(
+		compression_state,
+		reinterpret_cast<const std::byte*>(pixels),
+		std::size_t(baked.atlas_image_size.area()) * sizeof(rgba),
+		file_bytes
+	);
+
+	/* Write to a temporary file first so that an interrupted save never leaves a truncated atlas behind. */
+	auto temporary_path = path;
+	temporary_path += ".tmp";
+
+	try {
+		augs::create_directories_for(path);
+		augs::bytes_to_file(file_bytes, temporary_path);
+		std::filesystem::rename(temporary_path, path);
+	}
+	catch (const std::exception& err) {
+		LOG("Failed to save the atlas to cache at %x: %x", path, err.what());
+		augs::remove_file(temporary_path);
+	}
+}
+
+static void remove_least_recently_used(const atlas_cache_input cache) {
+	using entry_type = std::pair<std::filesystem::file_time_type, augs::path_type>;
+
+	std::vector<entry_type> cached_atlases;
+
+	try {
+		augs::for_each_in_directory(
+			cache.cache_dir,
+			[](const auto&) { return callback_result::CONTINUE; },
+			[&](const auto& path) {
+				if (path.extension() == cached_atlas_extension) {
+					cached_atlases.emplace_back(augs::last_write_time(path), path);
+				}
+
+				return callback_result::CONTINUE;
+			}
+		);
+	}
+	catch (const std::exception& err) {
+		LOG("Failed to list the atlas cache at %x: %x", cache.cache_dir, err.what());
+		return;
+	}
+
+	if (cached_atlases.size() <= cache.max_cached_atlases) {
+		return;
+	}
+
+	std::sort(
+		cached_atlases.begin(),
+		cached_atlases.end(),
+		[](const entry_type& a, const entry_type& b) { return a.first > b.first; }
+	);
+
+	for (std::size_t i = cache.max_cached_atlases; i < cached_atlases.size(); ++i) {
+		LOG("Removing the least recently used atlas: %x", cached_atlases[i].second);
+		augs::remove_file(cached_atlases[i].second);
+	}
+}
+
+void bake_cached_atlas(
+	const bake_fresh_atlas_input in,
+	const bake_fresh_atlas_output out,
+	const atlas_cache_input cache
+) {
+	auto& profiler = out.profiler;
+
+	const auto key = [&]() {
+		auto scope = measure_scope(profiler.calculating_cache_key);
+		return calc_cache_key(in);
+	}();
+
+	const auto path = cache.cache_dir / (std::string(augs::to_hex_format(key)) + cached_atlas_extension);
+
+	profiler.cache_hit.start();
+
+	if (try_load_cached_atlas(path, in, out)) {
+		profiler.cache_hit.stop();
+		return;
+	}
+
+	auto scope = measure_scope(profiler.cache_miss);
+
+	bake_fresh_atlas(in, out);
+
+	{
+		auto saving_scope = measure_scope(profiler.saving_to_cache);
+
+		save_atlas_to_cache(path, out);
+		remove_least_recently_used(cache);
+	}
+}
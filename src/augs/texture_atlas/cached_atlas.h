@@ -0,0 +1,23 @@
+#pragma once
+#include "augs/texture_atlas/bake_fresh_atlas.h"
+
+struct atlas_cache_input {
+	const augs::path_type& cache_dir;
+	const unsigned max_cached_atlases;
+};
+
+/*
+	The cache is keyed by the hashes of the contents of all input images and fonts,
+	together with their paths and max_atlas_size.
+	A cached atlas holds the whole packed layout and the LZ4-compressed pixels,
+	so a repeated load only decompresses them straight into the output image.
+
+	On a miss, the atlas is baked fresh and saved.
+	The least recently used atlases are removed once there are more than max_cached_atlases.
+*/
+
+void bake_cached_atlas(
+	bake_fresh_atlas_input,
+	bake_fresh_atlas_output,
+	atlas_cache_input
+);
@@ -53,6 +53,11 @@ namespace augs {
 #endif
 			config.outputFilename = settings.redirect_log_to_path.string();
 			config.runOrder = Catch::RunTests::InWhatOrder::InDeclarationOrder;
+
+			if (settings.run_benchmarks) {
+				/* Benchmarks are hidden with [.bench] so that they stay out of the regular run. */
+				config.testsOrTags = { "[bench]" };
+			}
 		}
 
 		if (const auto result = session.run();
@@ -8,6 +8,7 @@ struct unit_tests_settings {
 	bool run = false;
 	bool log_successful = false;
 	bool break_on_failure = false;
+	bool run_benchmarks = false;
 
 	augs::path_type redirect_log_to_path = "";
 	// END GEN INTROSPECTOR
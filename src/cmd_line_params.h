@@ -136,6 +136,9 @@ struct cmd_line_params {
 			else if (a == "--masterserver") {
 				type = app_type::MASTERSERVER;
 			}
+			else if (a == "--load-test") {
+				type = app_type::LOAD_TEST;
+			}
 			else if (a == "--test-fp-consistency") {
 				test_fp_consistency = std::atoi(get_next());
 				keep_cwd = true;
@@ -191,6 +194,6 @@ struct cmd_line_params {
 	}
 
 	bool is_cli_tool() const {
-		return type == app_type::MASTERSERVER || type == app_type::DEDICATED_SERVER;
+		return type == app_type::MASTERSERVER || type == app_type::DEDICATED_SERVER || type == app_type::LOAD_TEST;
 	}
 };
\ No newline at end of file
@@ -10,6 +10,9 @@ void cosmos::change_common_significant(F&& callback) {
 	auto& self = *this;
 
 	auto refresh_when_done = augs::scope_guard([&]() {
+		/* Even if not reinferred, the significant might have changed. */
+		common.mark_changed();
+
 		if (status != changer_callback_result::DONT_REFRESH) {
 			/*	
 				Always first reinfer the common,
@@ -8,11 +8,20 @@ template <class C, class F>
 void cosmic::change_solvable_significant(C& cosm, F&& callback) {
 	auto status = changer_callback_result::INVALID;
 
+	auto& significant = cosm.get_solvable({}).significant;
+
 	auto refresh_when_done = augs::scope_guard([&]() {
+		/* 
+			The callback might have read or assigned the significant wholesale,
+			bypassing get_pool, so the incremental solvable assignment has to copy every pool.
+		*/
+
+		significant.pool_mutations.mark_all();
+
 		if (status != changer_callback_result::DONT_REFRESH) {
 			reinfer_solvable(cosm);
 		}
 	});
 
-	status = callback(cosm.get_solvable({}).significant);
+	status = callback(significant);
 }
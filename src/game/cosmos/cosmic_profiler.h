@@ -40,6 +40,9 @@ struct cosmic_profiler : public augs::profiler_mixin<cosmic_profiler> {
 	augs::amount_measurements<std::size_t> delta_bytes = 1;
 
 	augs::time_measurements duplication = 1;
+	augs::time_measurements solvable_assignment = 1;
+	augs::time_measurements physics_cloning = 1;
+	augs::amount_measurements<std::size_t> copied_entity_pools = 1;
 
 	augs::time_measurements delta_encoding = 1;
 	augs::time_measurements delta_decoding = 1;
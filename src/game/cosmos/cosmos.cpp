@@ -1,7 +1,9 @@
 #include "augs/ensure_rel.h"
+#include "augs/log.h"
 #include "3rdparty/crc32/crc32.h"
 
 #include "augs/readwrite/memory_stream.h"
+#include "augs/misc/readable_bytesize.h"
 
 #include "augs/misc/randomization.h"
 
@@ -18,6 +20,9 @@
 
 #include <atomic>
 
+/* Set to 0 to compare reprediction times against full copies of the solvable. */
+#define INCREMENTAL_SOLVABLE_ASSIGNMENT 1
+
 std::atomic<int> cosmos_counter = 0;
 
 void cosmos::request_resample() {
@@ -50,6 +55,8 @@ cosmos& cosmos::operator=(const cosmos& b) {
 	solvable = b.solvable;
 	profiler = b.profiler;
 
+	last_set_reinferred.reset();
+
 	cosmic::after_solvable_copy(*this, b);
 	return *this;
 }
@@ -137,7 +144,24 @@ bool cosmos::completely_unset() const {
 	return empty() && get_common_significant().flavours.size() == 0;
 }
 
+cosmos::reinferred_state_key cosmos::make_reinferred_state_key(const cosmos_solvable_significant& signi) const {
+	reinferred_state_key key;
+
+	key.significant_instance = signi.pool_mutations.get_instance_id();
+	key.significant_pools = signi.pool_mutations.get_counters();
+	key.common_revision = common.revision;
+
+	return key;
+}
+
 void cosmos::set(const cosmos_solvable_significant& new_signi) {
+	const auto key = make_reinferred_state_key(new_signi);
+
+	if (should_keep_last_set_reinferred && last_set_reinferred != nullptr && last_set_key == key) {
+		assign_solvable(*last_set_reinferred);
+		return;
+	}
+
 	cosmic::change_solvable_significant(*this, [&](cosmos_solvable_significant& current_signi){ 
 		{
 			auto scope = measure_scope(profiler.duplication);
@@ -146,6 +170,51 @@ void cosmos::set(const cosmos_solvable_significant& new_signi) {
 
 		return changer_callback_result::REFRESH; 
 	});
+
+	if (should_keep_last_set_reinferred) {
+		const auto copy_bytes = estimate_copy_bytes();
+
+		if (copy_bytes > max_last_set_reinferred_bytes) {
+			LOG(
+				"Not keeping the reinferred round state: it would take %x, over the limit of %x.", 
+				readable_bytesize(copy_bytes),
+				readable_bytesize(max_last_set_reinferred_bytes)
+			);
+
+			last_set_reinferred.reset();
+			return;
+		}
+
+		if (last_set_reinferred == nullptr) {
+			last_set_reinferred = std::make_unique<cosmos>(*this);
+		}
+		else {
+			/* Reuses the storage of the previous copy, including the chunks of its physics world. */
+			*last_set_reinferred = *this;
+		}
+
+		last_set_key = key;
+
+		LOG("Keeping the reinferred round state for round restarts. It takes about %x.", readable_bytesize(copy_bytes));
+	}
+}
+
+void cosmos::keep_last_set_reinferred(const bool flag, const std::size_t max_bytes) {
+	should_keep_last_set_reinferred = flag;
+	max_last_set_reinferred_bytes = max_bytes;
+
+	if (!flag) {
+		last_set_reinferred.reset();
+	}
+}
+
+std::size_t cosmos::estimate_copy_bytes() const {
+	augs::byte_counter_stream counter;
+
+	augs::write_bytes(counter, get_common_significant());
+	augs::write_bytes(counter, get_solvable().significant);
+
+	return counter.size() + get_solvable_inferred().physics.get_allocated_bytes();
 }
 
 void cosmos::reinfer_everything() {
@@ -167,7 +236,22 @@ void cosmos::set_fixed_delta(const augs::delta& dt) {
 }
 
 void cosmos::assign_solvable(const cosmos& b) {
-	solvable = b.solvable;
+	{
+		auto scope = measure_scope(profiler.solvable_assignment);
+
+#if INCREMENTAL_SOLVABLE_ASSIGNMENT
+		auto& target = solvable.get_solvable({});
+		const auto& source = b.get_solvable();
+
+		const auto num_copied_pools = target.significant.assign_changed_pools(source.significant, last_solvable_sync);
+		profiler.copied_entity_pools.measure(num_copied_pools);
+
+		target.inferred = source.inferred;
+#else
+		solvable = b.solvable;
+#endif
+	}
 
+	auto scope = measure_scope(profiler.physics_cloning);
 	cosmic::after_solvable_copy(*this, b);
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include "augs/build_settings/compiler_defines.h"
 #include "augs/misc/randomization_declaration.h"
 
@@ -29,6 +30,34 @@ class cosmos {
 	cosmos_id_type cosmos_id = 0;
 	mutable bool resample = true;
 
+	pool_sync_state last_solvable_sync;
+
+	struct reinferred_state_key {
+		uint64_t significant_instance = 0;
+		pool_mutation_counters_array significant_pools = {};
+		uint64_t common_revision = 0;
+
+		bool operator==(const reinferred_state_key&) const = default;
+	};
+
+	/*
+		A reinferred copy of this cosmos right after the last set().
+		Every round restart sets the very same clean round state,
+		so instead of rebuilding the physics world and all other inferred caches from scratch,
+		the copy is assigned together with its inferred state.
+
+		The copy is as large as the cosmos itself, 
+		so it is only kept by the cosmos that asked for it,
+		and only if it fits in max_last_set_reinferred_bytes.
+	*/
+
+	bool should_keep_last_set_reinferred = false;
+	std::size_t max_last_set_reinferred_bytes = 0;
+	std::unique_ptr<cosmos> last_set_reinferred;
+	reinferred_state_key last_set_key;
+
+	reinferred_state_key make_reinferred_state_key(const cosmos_solvable_significant&) const;
+
 public: 
 	/* A detail only for performance benchmarks */
 	mutable cosmic_profiler profiler;
@@ -57,6 +86,16 @@ public:
 
 	void set(const cosmos_solvable_significant& signi);
 
+	/* Not copied along with the cosmos. */
+	void keep_last_set_reinferred(bool flag, std::size_t max_bytes);
+
+	/* 
+		Approximate memory taken by a copy of this cosmos:
+		the serialized size of both significant states plus the physics world.
+	*/
+
+	std::size_t estimate_copy_bytes() const;
+
 	si_scaling get_si() const {
 		return get_common_significant().si;
 	}
@@ -73,6 +112,7 @@ public:
 	}
 
 	cosmos_common_significant& get_common_significant(cosmos_common_significant_access) {
+		common.mark_changed();
 		return common.significant;
 	}
 
@@ -162,6 +202,9 @@ public:
 	template <class... MustHaveComponents, class F>
 	void for_each_having(F&& callback) const;
 
+	template <class... MustHaveComponents>
+	std::size_t count_having() const;
+
 	template <class... MustHaveInvariants, class F>
 	void for_each_flavour_having(F&& callback) const;
 
@@ -308,6 +351,11 @@ public:
 
 	void set_fixed_delta(const augs::delta& dt);
 
+	/*
+		Only copies the entity pools that could have changed 
+		in either cosmos since the last assign_solvable from the same source.
+	*/
+
 	void assign_solvable(const cosmos& b);
 
 	template <class T>
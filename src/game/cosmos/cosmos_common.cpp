@@ -1,5 +1,11 @@
+#include <atomic>
 #include "game/cosmos/cosmos_common.h"
 
+uint64_t cosmos_common::next_revision() {
+	static std::atomic<uint64_t> revision_counter = 1;
+	return revision_counter++;
+}
+
 void cosmos_common::reinfer() {
-	
+	mark_changed();
 }
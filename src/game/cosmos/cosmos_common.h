@@ -1,8 +1,22 @@
 #pragma once
+#include <cstdint>
 #include "game/cosmos/cosmos_common_significant.h"
 
 struct cosmos_common {
 	cosmos_common_significant significant;
 
+	/* 
+		Changes whenever the significant might have been altered.
+		Copies share the revision, as they have the same contents.
+	*/
+
+	uint64_t revision = next_revision();
+
+	static uint64_t next_revision();
+
+	void mark_changed() {
+		revision = next_revision();
+	}
+
 	void reinfer();
 };
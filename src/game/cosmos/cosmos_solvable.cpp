@@ -11,6 +11,7 @@ const cosmos_solvable cosmos_solvable::zero;
 void cosmos_solvable::clear() {
 	destroy_all_caches();
 	significant.entity_pools.clear();
+	significant.pool_mutations.mark_all();
 	significant.clk = {};
 	significant.specific_names.clear();
 }
@@ -45,7 +46,7 @@ void cosmos_solvable::reserve_storage_for_entities(const cosmic_pool_size_type n
 void cosmos_solvable::destroy_all_caches() {
 	inferred.~cosmos_solvable_inferred();
 
-	significant.entity_pools.for_each_container(
+	significant.for_each_entity_pool(
 		[&](auto& entity_pool) {
 			using E = entity_type_of<typename remove_cref<decltype(entity_pool)>::value_type>;
 
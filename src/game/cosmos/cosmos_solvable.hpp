@@ -4,15 +4,19 @@
 
 template <template <class> class Predicate, class S, class F>
 void cosmos_solvable::for_each_entity_impl(S& self, F callback) {
-	self.significant.for_each_entity_pool(
-		[&](auto& p) {
-			using P = decltype(p);
-			using pool_type = remove_cref<P>;
+	/* 
+		Iterate the pools directly so that only the pools matching the predicate
+		are counted as mutated when iterating a non-const solvable.
+	*/
 
+	self.significant.entity_pools.for_each_container(
+		[&]<class pool_type>(const pool_type&) {
 			using Solvable = typename pool_type::mapped_type;
 			using E = entity_type_of<Solvable>;
 
 			if constexpr(Predicate<E>::value) {
+				auto& p = self.significant.template get_pool<E>();
+
 				using index_type = typename pool_type::used_size_type;
 
 				for (index_type i = 0; i < p.size(); ++i) {
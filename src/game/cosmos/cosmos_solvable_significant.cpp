@@ -4,8 +4,36 @@
 
 #include "game/organization/all_component_includes.h"
 #include "game/cosmos/cosmos.h"
+#include "game/cosmos/typed_entity_handle_declaration.h"
 
 void cosmos_solvable_significant::clear() {
 	*this = cosmos_solvable_significant();
 	global.clear();
-}
\ No newline at end of file
+}
+std::size_t cosmos_solvable_significant::assign_changed_pools(
+	const cosmos_solvable_significant& source, 
+	pool_sync_state& state
+) {
+	std::size_t num_copied_pools = 0;
+
+	source.for_each_entity_pool(
+		[&](const auto& source_pool) {
+			using P = remove_cref<decltype(source_pool)>;
+			using E = entity_type_of<typename P::value_type>;
+
+			if (!state.pool_unchanged(ENTITY_TYPE_IDX<E>, source.pool_mutations, pool_mutations)) {
+				/* Bypass get_pool so that the assignment itself does not count as a mutation. */
+				entity_pools.template get_for<E>() = source_pool;
+				++num_copied_pools;
+			}
+		}
+	);
+
+	clk = source.clk;
+	specific_names = source.specific_names;
+	global = source.global;
+
+	state.remember(source.pool_mutations, pool_mutations);
+
+	return num_copied_pools;
+}
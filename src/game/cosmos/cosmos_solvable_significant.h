@@ -11,6 +11,7 @@
 #include "game/common_state/entity_name_str.h"
 #include "game/cosmos/entity_id.h"
 #include "game/cosmos/cosmos_global_solvable.h"
+#include "game/cosmos/pool_mutation_counters.h"
 
 #include "augs/misc/assignment_detector.h"
 
@@ -26,9 +27,11 @@ struct cosmos_solvable_significant {
 	// END GEN INTROSPECTOR
 
 	mutable augs::assignment_detector assignment_detector;
+	pool_mutation_counters pool_mutations;
 
 	template <class E>
 	auto& get_pool() {
+		pool_mutations.mark<E>();
 		return entity_pools.get_for<E>();
 	}
 
@@ -39,6 +42,7 @@ struct cosmos_solvable_significant {
 
 	template <class F>
 	decltype(auto) on_pool(const entity_type_id id, F&& callback) {
+		pool_mutations.mark(id.get_index());
 		return entity_pools.visit(id, std::forward<F>(callback));
 	}
 
@@ -49,6 +53,7 @@ struct cosmos_solvable_significant {
 
 	template <class F>
 	decltype(auto) for_each_entity_pool(F&& callback) {
+		pool_mutations.mark_all();
 		return entity_pools.for_each_container(std::forward<F>(callback));
 	}
 
@@ -58,4 +63,13 @@ struct cosmos_solvable_significant {
 	}
 
 	void clear();
+
+	/*
+		Used for reprediction.
+		Skips the entity pools that were not accessed for writing
+		in either this or the source object since the last call with the same sync state.
+		Returns the number of copied pools.
+	*/
+
+	std::size_t assign_changed_pools(const cosmos_solvable_significant& source, pool_sync_state& state);
 };
\ No newline at end of file
@@ -27,6 +27,21 @@ void cosmos::for_each_having(F&& callback) const {
 	cosmic::for_each_entity<has_all_of<MustHaveComponents...>::template type>(*this, std::forward<F>(callback));
 }
 
+template <class... MustHaveComponents>
+std::size_t cosmos::count_having() const {
+	std::size_t total = 0;
+
+	for_each_entity_type([&](auto e) {
+		using E = decltype(e);
+
+		if constexpr(has_all_of_v<E, MustHaveComponents...>) {
+			total += get_solvable().template get_count_of<E>();
+		}
+	});
+
+	return total;
+}
+
 template <template <class> class Predicate, class F>
 void cosmos::for_each_entity(F&& callback) {
 	cosmic::for_each_entity<Predicate>(*this, std::forward<F>(callback));
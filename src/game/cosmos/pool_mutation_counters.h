@@ -0,0 +1,116 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "game/organization/all_entity_types_declaration.h"
+
+using pool_mutation_counter_type = uint64_t;
+using pool_mutation_counters_array = std::array<pool_mutation_counter_type, ENTITY_TYPES_COUNT>;
+
+/*
+	Counts non-const accesses to every entity pool of a cosmos_solvable_significant.
+	This is conservative: any access that could have mutated a pool counts as a mutation.
+
+	Solver phases may run in parallel, so the counters are relaxed atomics.
+	A lost increment is harmless: every write still leaves a value greater than the one
+	remembered at the last synchronization.
+
+	Copying or assigning a significant does not copy the counters.
+	Instead, the target is given a new identity and all of its pools are considered mutated,
+	so that the target is never mistaken for its previous contents.
+*/
+
+class pool_mutation_counters {
+	static uint64_t next_instance_id() {
+		static std::atomic<uint64_t> instance_counter = 1;
+		return instance_counter++;
+	}
+
+	uint64_t instance_id = next_instance_id();
+	std::array<std::atomic<pool_mutation_counter_type>, ENTITY_TYPES_COUNT> counters = {};
+
+	static void bump(std::atomic<pool_mutation_counter_type>& c) {
+		c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	void mark_all_reassigned() {
+		instance_id = next_instance_id();
+		mark_all();
+	}
+
+public:
+	pool_mutation_counters() = default;
+
+	pool_mutation_counters(const pool_mutation_counters&) {}
+
+	pool_mutation_counters& operator=(const pool_mutation_counters&) {
+		mark_all_reassigned();
+		return *this;
+	}
+
+	void mark(const std::size_t type_index) {
+		bump(counters[type_index]);
+	}
+
+	template <class E>
+	void mark() {
+		bump(counters[ENTITY_TYPE_IDX<E>]);
+	}
+
+	void mark_all() {
+		for (auto& c : counters) {
+			bump(c);
+		}
+	}
+
+	auto get_instance_id() const {
+		return instance_id;
+	}
+
+	auto get(const std::size_t type_index) const {
+		return counters[type_index].load(std::memory_order_relaxed);
+	}
+
+	auto get_counters() const {
+		pool_mutation_counters_array result;
+
+		for (std::size_t i = 0; i < result.size(); ++i) {
+			result[i] = get(i);
+		}
+
+		return result;
+	}
+};
+
+/*
+	Remembers the counters of both objects from the moment of their last synchronization.
+	Owned by the object that is being assigned to.
+*/
+
+struct pool_sync_state {
+	uint64_t source_instance_id = 0;
+	pool_mutation_counters_array source_counters = {};
+	pool_mutation_counters_array target_counters = {};
+
+	bool pool_unchanged(
+		const std::size_t type_index,
+		const pool_mutation_counters& source,
+		const pool_mutation_counters& target
+	) const {
+		return
+			source_instance_id == source.get_instance_id()
+			&& source_counters[type_index] == source.get(type_index)
+			&& target_counters[type_index] == target.get(type_index)
+		;
+	}
+
+	void remember(
+		const pool_mutation_counters& source,
+		const pool_mutation_counters& target
+	) {
+		source_instance_id = source.get_instance_id();
+		source_counters = source.get_counters();
+		target_counters = target.get_counters();
+	}
+};
@@ -2,6 +2,19 @@
 #include "game/cosmos/entity_id.h"
 #include "game/detail/view_input/predictability_info.h"
 
+namespace augs {
+	class thread_pool;
+}
+
+/*
+	What the standard solver's phases read and write is declared by hand,
+	and nothing checks it against what the systems actually access.
+	A wrong declaration would silently break determinism,
+	so the standard solver runs every group serially until the declarations are verified.
+*/
+
+#define PARALLEL_STANDARD_SOLVER_PHASES 0
+
 struct solve_result {
 	bool state_inconsistent = false;
 };
@@ -14,4 +27,12 @@ struct solve_settings {
 	bool drop_weapons_if_empty = true;
 
 	bool pause_simulation = false;
+
+	/* 
+		If set, independent solver phases run in parallel on these workers.
+		The result is bit-identical to the serial path.
+	*/
+
+	augs::thread_pool* phase_workers = nullptr;
+	std::size_t min_parallel_phase_work = 512;
 };
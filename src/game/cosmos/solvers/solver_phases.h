@@ -0,0 +1,109 @@
+#pragma once
+#include <array>
+
+#include "augs/templates/folded_finders.h"
+#include "augs/templates/thread_pool.h"
+
+#include "game/cosmos/logic_step.h"
+#include "game/cosmos/data_living_one_step.h"
+
+/*
+	A solver phase is a struct that declares what it accesses:
+
+		reads_queues	- message queues that it reads,
+		posts			- message queues that it appends to,
+		reads			- components that it only reads,
+		writes			- components that it writes to,
+		uses_step_rng	- whether it draws from the step's randomization,
+
+	a static count_work(logic_step) that estimates how many entities or messages it will process,
+	and a static solve(logic_step) that calls the corresponding system.
+
+	Phases of a group must be pairwise independent, which is checked at compile time.
+	In parallel, every phase gets its own message queues, primed with copies of the queues it reads.
+	Once all phases complete, whatever they posted is appended to the step's queues
+	in the order of the phases' declaration, so the result is bit-identical to running them one after another.
+*/
+
+template <class A, class B>
+constexpr bool solver_phases_independent_v =
+	!lists_intersect_v<typename A::writes, typename B::writes>
+	&& !lists_intersect_v<typename A::writes, typename B::reads>
+	&& !lists_intersect_v<typename B::writes, typename A::reads>
+	&& !lists_intersect_v<typename A::posts, typename B::reads_queues>
+	&& !lists_intersect_v<typename B::posts, typename A::reads_queues>
+	&& !(A::uses_step_rng && B::uses_step_rng)
+;
+
+template <class A, class... Others>
+constexpr bool independent_of_all_v = (true && ... && solver_phases_independent_v<A, Others>);
+
+template <class... Phases>
+struct all_pairwise_independent;
+
+template <>
+struct all_pairwise_independent<> : std::true_type {};
+
+template <class First, class... Rest>
+struct all_pairwise_independent<First, Rest...> : std::bool_constant<
+	independent_of_all_v<First, Rest...> && all_pairwise_independent<Rest...>::value
+> {};
+
+template <class List>
+struct copy_message_queues;
+
+template <template <class...> class L, class... Messages>
+struct copy_message_queues<L<Messages...>> {
+	static void perform(const all_message_queues& from, all_message_queues& to) {
+		((to.template get_queue<Messages>() = from.template get_queue<Messages>()), ...);
+	}
+};
+
+template <class... Phases>
+void solve_phases(const logic_step step, augs::thread_pool* const pool) {
+	static_assert(
+		all_pairwise_independent<Phases...>::value,
+		"Solver phases of one group must not write what the others read or write, and at most one may use the step rng."
+	);
+
+	const auto min_work = step.get_settings().min_parallel_phase_work;
+
+	if (pool == nullptr || !((Phases::count_work(step) >= min_work) && ...)) {
+		(Phases::solve(step), ...);
+		return;
+	}
+
+	using queue_sizes = all_message_queues::queue_sizes;
+
+	constexpr auto num_phases = sizeof...(Phases);
+
+	thread_local std::array<data_living_one_step, num_phases> phase_transients;
+	std::array<queue_sizes, num_phases> primed_sizes;
+
+	std::size_t i = 0;
+
+	auto enqueue_phase = [&]<class P>(P*) {
+		auto& phase_transient = phase_transients[i];
+		phase_transient.flush_everything();
+
+		copy_message_queues<typename P::reads_queues>::perform(step.transient.messages, phase_transient.messages);
+
+		primed_sizes[i] = phase_transient.messages.get_queue_sizes();
+
+		pool->enqueue([phase_step = step.with_transient(phase_transient)]() {
+			P::solve(phase_step);
+		});
+
+		++i;
+	};
+
+	(enqueue_phase(static_cast<Phases*>(nullptr)), ...);
+
+	pool->submit();
+	pool->help_until_no_tasks();
+	pool->wait_for_all_tasks_to_complete();
+
+	for (std::size_t p = 0; p < num_phases; ++p) {
+		step.transient.messages.append_posted_since(phase_transients[p].messages, primed_sizes[p]);
+	}
+}
@@ -5,6 +5,7 @@
 #include "game/cosmos/cosmos.h"
 #include "game/cosmos/cosmic_functions.h"
 #include "game/cosmos/entity_handle.h"
+#include "game/cosmos/for_each_entity.h"
 #include "game/cosmos/data_living_one_step.h"
 
 #include "game/detail/inventory/perform_transfer.h"
@@ -39,6 +40,7 @@
 #include "game/stateless_systems/portal_system.h"
 
 #include "game/organization/all_messages_includes.h"
+#include "game/cosmos/solvers/solver_phases.h"
 
 #define STRESS_TEST_REINFERENCES 0
 
@@ -53,6 +55,126 @@ data_living_one_step& standard_solver::get_thread_local_queues() {
 	return queues;
 }
 
+struct lengthen_traces_phase {
+	using reads_queues = type_list<>;
+	using posts = type_list<>;
+	using reads = type_list<invariants::trace>;
+	using writes = type_list<components::trace>;
+	static constexpr bool uses_step_rng = false;
+
+	static std::size_t count_work(const logic_step step) {
+		return step.get_cosmos().count_having<components::trace>();
+	}
+
+	static void solve(const logic_step step) {
+		trace_system().lengthen_sprites_of_traces(step);
+	}
+};
+
+struct integrate_crosshair_recoils_phase {
+	using reads_queues = type_list<>;
+	using posts = type_list<>;
+	using reads = type_list<invariants::crosshair, invariants::sentience>;
+	using writes = type_list<components::crosshair, components::sentience>;
+	static constexpr bool uses_step_rng = false;
+
+	static std::size_t count_work(const logic_step step) {
+		return step.get_cosmos().count_having<components::crosshair>();
+	}
+
+	static void solve(const logic_step step) {
+		crosshair_system().integrate_crosshair_recoils(step);
+	}
+};
+
+struct play_particles_from_events_phase {
+	using reads_queues = type_list<
+		messages::gunshot_message,
+		messages::damage_message,
+		messages::health_event,
+		messages::exhausted_cast
+	>;
+
+	using posts = type_list<
+		messages::start_particle_effect,
+		messages::stop_particle_effect,
+		messages::exploding_ring_effect,
+		messages::thunder_effect
+	>;
+
+	using reads = type_list<
+		invariants::missile,
+		invariants::sentience,
+		invariants::explosive,
+		components::transform,
+		components::sentience
+	>;
+
+	using writes = type_list<>;
+	static constexpr bool uses_step_rng = false;
+
+	static std::size_t count_work(const logic_step step) {
+		return 
+			step.get_queue<messages::gunshot_message>().size()
+			+ step.get_queue<messages::damage_message>().size()
+			+ step.get_queue<messages::health_event>().size()
+			+ step.get_queue<messages::exhausted_cast>().size()
+		;
+	}
+
+	static void solve(const logic_step step) {
+		particles_existence_system().play_particles_from_events(step);
+	}
+};
+
+struct displace_streams_phase {
+	using reads_queues = type_list<>;
+	using posts = type_list<>;
+	using reads = type_list<invariants::continuous_particles>;
+	using writes = type_list<components::continuous_particles>;
+	static constexpr bool uses_step_rng = true;
+
+	static std::size_t count_work(const logic_step step) {
+		return step.get_cosmos().count_having<components::continuous_particles>();
+	}
+
+	static void solve(const logic_step step) {
+		particles_existence_system().displace_streams(step);
+	}
+};
+
+struct destroy_outdated_traces_phase {
+	using reads_queues = type_list<>;
+	using posts = type_list<messages::queue_deletion>;
+	using reads = type_list<>;
+	using writes = type_list<components::trace>;
+	static constexpr bool uses_step_rng = false;
+
+	static std::size_t count_work(const logic_step step) {
+		return step.get_cosmos().count_having<components::trace>();
+	}
+
+	static void solve(const logic_step step) {
+		trace_system().destroy_outdated_traces(step);
+	}
+};
+
+struct shrink_and_destroy_remnants_phase {
+	using reads_queues = type_list<>;
+	using posts = type_list<messages::queue_deletion>;
+	using reads = type_list<invariants::remnant>;
+	using writes = type_list<components::remnant>;
+	static constexpr bool uses_step_rng = false;
+
+	static std::size_t count_work(const logic_step step) {
+		return step.get_cosmos().count_having<components::remnant>();
+	}
+
+	static void solve(const logic_step step) {
+		remnant_system().shrink_and_destroy_remnants(step);
+	}
+};
+
 void standard_solve(const logic_step step) {
 	auto& cosm = step.get_cosmos();
 	auto& performance = cosm.profiler;
@@ -89,6 +211,11 @@ void standard_solve(const logic_step step) {
 	}
 
 	auto& global = cosm.get_global_solvable();
+#if PARALLEL_STANDARD_SOLVER_PHASES
+	const auto phase_workers = step.get_settings().phase_workers;
+#else
+	augs::thread_pool* const phase_workers = nullptr;
+#endif
 
 #if STRESS_TEST_REINFERENCES
 	{
@@ -213,9 +340,10 @@ void standard_solve(const logic_step step) {
 	physics_system().post_and_clear_accumulated_collision_messages(step);
 	portal_system().advance_portal_logic(step);
 
-	trace_system().lengthen_sprites_of_traces(step);
-
-	crosshair_system().integrate_crosshair_recoils(step);
+	solve_phases<
+		lengthen_traces_phase,
+		integrate_crosshair_recoils_phase
+	>(step, phase_workers);
 
 	{
 		auto scope = measure_scope(performance.missiles);
@@ -249,8 +377,11 @@ void standard_solve(const logic_step step) {
 	driver_system().assign_drivers_who_touch_wheels(step);
 	driver_system().release_drivers_due_to_ending_contact_with_wheel(step);
 
-	particles_existence_system().play_particles_from_events(step);
-	particles_existence_system().displace_streams(step);
+	solve_phases<
+		play_particles_from_events_phase,
+		displace_streams_phase
+	>(step, phase_workers);
+
 	sound_existence_system().play_sounds_from_events(step);
 
 #if TODO_VISIBILITY
@@ -281,8 +412,10 @@ void standard_solve(const logic_step step) {
 		perform_transfers(transfers, step);
 	}
 
-	trace_system().destroy_outdated_traces(step);
-	remnant_system().shrink_and_destroy_remnants(step);
+	solve_phases<
+		destroy_outdated_traces_phase,
+		shrink_and_destroy_remnants_phase
+	>(step, phase_workers);
 
 	const auto queued_before_marking_num = step.get_queue<messages::queue_deletion>().size();
 	(void)queued_before_marking_num;
@@ -18,6 +18,21 @@
 #include "augs/readwrite/byte_readwrite.h"
 #include "augs/readwrite/lua_readwrite.h"
 #include "augs/log_path_getters.h"
+#include "augs/misc/randomization.h"
+#include "augs/templates/thread_pool.h"
+
+#include "game/cosmos/logic_step.h"
+#include "game/cosmos/data_living_one_step.h"
+#include "game/cosmos/solvers/solver_phases.h"
+#include "game/cosmos/solvers/standard_solver.h"
+#include "game/cosmos/for_each_entity.h"
+#include "game/cosmos/change_solvable_significant.h"
+
+#if BUILD_TEST_SCENES
+#include "augs/misc/lua/lua_utils.h"
+#include "application/intercosm.h"
+#include "test_scenes/test_scene_settings.h"
+#endif
 
 TEST_CASE("StateTest0 PaddingSanityCheck1") {
 	struct ok {
@@ -215,5 +230,164 @@ TEST_CASE("StateTest2 PaddingTest") {
 #endif
 #endif
 }
+
+template <unsigned first_index, bool draws_rng>
+struct test_deletion_phase {
+	using reads_queues = type_list<>;
+	using posts = type_list<messages::queue_deletion>;
+	using reads = type_list<>;
+	using writes = type_list<>;
+	static constexpr bool uses_step_rng = draws_rng;
+
+	static std::size_t count_work(const logic_step) {
+		return 1000;
+	}
+
+	static void solve(const logic_step step) {
+		for (unsigned i = 0; i < 1000; ++i) {
+			entity_id id;
+			id.raw.indirection_index = first_index + i;
+
+			if constexpr(draws_rng) {
+				id.raw.version = step.step_rng.randval(0u, 1000u);
+			}
+
+			step.post_message(messages::queue_deletion(id));
+		}
+	}
+};
+
+TEST_CASE("StateTest3 ParallelPhasesMatchSerial") {
+	using A = test_deletion_phase<0, true>;
+	using B = test_deletion_phase<10000, false>;
+	using C = test_deletion_phase<20000, false>;
+
+	cosmos cosm;
+	const cosmic_entropy entropy;
+	const solve_settings settings;
+	augs::thread_pool pool(4);
+
+	auto solve_with = [&](augs::thread_pool* const workers) {
+		data_living_one_step transient;
+		randomization rng(1337);
+		solve_result result;
+
+		const auto step = logic_step({ cosm, entropy, settings }, transient, rng, result);
+
+		solve_phases<A, B, C>(step, workers);
+
+		std::vector<entity_id> deleted;
+
+		for (const auto& m : step.get_queue<messages::queue_deletion>()) {
+			deleted.push_back(m.subject);
+		}
+
+		return deleted;
+	};
+
+	const auto serial = solve_with(nullptr);
+	REQUIRE(serial.size() == 3000);
+
+	for (int attempt = 0; attempt < 10; ++attempt) {
+		REQUIRE(serial == solve_with(&pool));
+	}
+}
+
+#if BUILD_TEST_SCENES && PARALLEL_STANDARD_SOLVER_PHASES
+TEST_CASE("StateTest4 ParallelSolverMatchesSerialHash") {
+	/* Every group is forced to run in parallel, however little it has to do. */
+
+	auto lua = augs::create_lua_state();
+	augs::thread_pool pool(2);
+
+	auto hash_after_steps = [&](augs::thread_pool* const workers) {
+		intercosm scene;
+		scene.make_test_scene(lua, test_scene_settings());
+
+		auto& cosm = scene.world;
+
+		solve_settings settings;
+		settings.phase_workers = workers;
+		settings.min_parallel_phase_work = 0;
+
+		cosmic_entropy shooting;
+
+		cosm.for_each_having<components::sentience>([&](const auto& character) {
+			auto& intents = shooting[character.get_id()].commands.intents;
+
+			intents.push_back({ game_intent_type::SHOOT, intent_change::PRESSED });
+			intents.push_back({ game_intent_type::MOVE_FORWARD, intent_change::PRESSED });
+		});
+
+		const cosmic_entropy no_input;
+
+		for (int i = 0; i < 300; ++i) {
+			standard_solver()({ cosm, i == 0 ? shooting : no_input, settings }, solver_callbacks());
+		}
+
+		return cosm.calculate_solvable_signi_hash<uint32_t>();
+	};
+
+	REQUIRE(hash_after_steps(nullptr) == hash_after_steps(&pool));
+}
+#endif
+
+#if BUILD_TEST_SCENES
+TEST_CASE("StateTest5 IncrementalAssignmentAfterReadingBytes") {
+	/* Reading the significant from bytes does not go through get_pool, yet must be fully copied. */
+
+	auto lua = augs::create_lua_state();
+
+	intercosm scene;
+	scene.make_test_scene(lua, test_scene_settings());
+
+	auto& source = scene.world;
+	auto target = std::make_unique<cosmos>(source);
+
+	auto to_bytes = [](const cosmos& cosm) {
+		augs::memory_stream s;
+		augs::write_bytes(s, cosm.get_solvable().significant);
+		return s;
+	};
+
+	auto equal = [](const augs::memory_stream& a, const augs::memory_stream& b) {
+		return a.size() == b.size() && a == b;
+	};
+
+	auto saved = to_bytes(source);
+
+	cosmic_entropy shooting;
+
+	source.for_each_having<components::sentience>([&](const auto& character) {
+		auto& intents = shooting[character.get_id()].commands.intents;
+
+		intents.push_back({ game_intent_type::SHOOT, intent_change::PRESSED });
+		intents.push_back({ game_intent_type::MOVE_FORWARD, intent_change::PRESSED });
+	});
+
+	const cosmic_entropy no_input;
+	const solve_settings settings;
+
+	for (int i = 0; i < 60; ++i) {
+		standard_solver()({ source, i == 0 ? shooting : no_input, settings }, solver_callbacks());
+	}
+
+	REQUIRE(!equal(to_bytes(source), saved));
+
+	target->assign_solvable(source);
+	REQUIRE(equal(to_bytes(source), to_bytes(*target)));
+
+	cosmic::change_solvable_significant(source, [&](cosmos_solvable_significant& significant) {
+		augs::read_bytes(saved, significant);
+		return changer_callback_result::REFRESH;
+	});
+
+	REQUIRE(equal(to_bytes(source), saved));
+
+	target->assign_solvable(source);
+	REQUIRE(equal(to_bytes(source), to_bytes(*target)));
+}
+#endif
+
 #endif
 #endif
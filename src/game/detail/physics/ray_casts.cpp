@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "game/inferred_caches/physics_world_cache.h"
 #include "game/cosmos/cosmos.h"
 #include "game/cosmos/entity_handle.h"
@@ -17,11 +19,15 @@ struct raycast_input : public b2RayCastCallback {
 	float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float32 fraction) override;
 };
 
-bool raycast_input::ShouldRaycast(b2Fixture* const fixture) {
-	const auto fixture_entity = fixture->GetBody()->GetUserData();
+static bool should_raycast(const b2Fixture& fixture, const entity_id subject, const b2Filter& subject_filter) {
+	const auto fixture_entity = fixture.GetBody()->GetUserData();
 	return
 		(subject == entity_id() || fixture_entity != FixtureUserdata(subject)) &&
-		(b2ContactFilter::ShouldCollide(&subject_filter, &fixture->GetFilterData()));
+		(b2ContactFilter::ShouldCollide(&subject_filter, &fixture.GetFilterData()));
+}
+
+bool raycast_input::ShouldRaycast(b2Fixture* const fixture) {
+	return should_raycast(*fixture, subject, subject_filter);
 }
 
 float32 raycast_input::ReportFixture(
@@ -147,6 +153,173 @@ physics_raycast_output physics_world_cache::ray_cast(const vec2 p1_meters, const
 	return callback.output;
 }
 
+struct ray_fan_candidate {
+	b2AABB aabb;
+	const b2Fixture* fixture = nullptr;
+	int32 child_index = 0;
+	float distance_sq = 0.f;
+};
+
+static bool segment_overlaps_aabb(
+	const b2Vec2 p1,
+	const b2Vec2 d,
+	const float max_fraction,
+	const b2AABB& aabb
+) {
+	float t_min = 0.f;
+	float t_max = max_fraction;
+
+	for (int32 i = 0; i < 2; ++i) {
+		const auto lower = aabb.lowerBound(i);
+		const auto upper = aabb.upperBound(i);
+
+		if (d(i) == 0.f) {
+			if (p1(i) < lower || p1(i) > upper) {
+				return false;
+			}
+
+			continue;
+		}
+
+		const auto inv_d = 1.f / d(i);
+
+		auto t1 = (lower - p1(i)) * inv_d;
+		auto t2 = (upper - p1(i)) * inv_d;
+
+		if (t1 > t2) {
+			std::swap(t1, t2);
+		}
+
+		t_min = std::max(t_min, t1);
+		t_max = std::min(t_max, t2);
+
+		if (t_min > t_max) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void physics_world_cache::ray_cast_fan(
+	const vec2 origin_meters,
+	const std::vector<vec2>& destinations_meters,
+	const b2Filter filter,
+	std::vector<physics_raycast_output>& outputs,
+	const entity_id ignore_entity
+) const {
+	outputs.clear();
+	outputs.resize(destinations_meters.size());
+
+	if (destinations_meters.empty()) {
+		return;
+	}
+
+	const auto p1 = b2Vec2(origin_meters);
+
+	b2AABB fan_aabb;
+	fan_aabb.lowerBound = fan_aabb.upperBound = p1;
+
+	for (const auto& d : destinations_meters) {
+		fan_aabb.lowerBound = b2Min(fan_aabb.lowerBound, b2Vec2(d));
+		fan_aabb.upperBound = b2Max(fan_aabb.upperBound, b2Vec2(d));
+	}
+
+	/* 
+		Gather every proxy that any of the rays could possibly visit,
+		using the same fat AABBs that the tree would test against.
+	*/
+
+	thread_local std::vector<ray_fan_candidate> candidates;
+	candidates.clear();
+
+	const auto& broad_phase = b2world->m_contactManager.m_broadPhase;
+
+	struct query_callback {
+		const b2BroadPhase& broad_phase;
+		const b2Vec2 p1;
+		const entity_id ignore_entity;
+		const b2Filter& filter;
+
+		bool QueryCallback(const int32 proxy_id) {
+			const auto& proxy = *static_cast<const b2FixtureProxy*>(broad_phase.GetUserData(proxy_id));
+
+			if (should_raycast(*proxy.fixture, ignore_entity, filter)) {
+				ray_fan_candidate c;
+				c.aabb = broad_phase.GetFatAABB(proxy_id);
+				c.fixture = proxy.fixture;
+				c.child_index = proxy.childIndex;
+
+				const auto closest = b2Clamp(p1, c.aabb.lowerBound, c.aabb.upperBound);
+				c.distance_sq = (closest - p1).LengthSquared();
+
+				candidates.push_back(c);
+			}
+
+			return true;
+		}
+	};
+
+	{
+		auto callback = query_callback { broad_phase, p1, ignore_entity, filter };
+		broad_phase.Query(&callback, fan_aabb);
+	}
+
+	/* 
+		Nearest first, so that once a ray hits something,
+		it can stop at the first candidate that lies entirely beyond the hit.
+	*/
+
+	std::sort(
+		candidates.begin(),
+		candidates.end(),
+		[](const ray_fan_candidate& a, const ray_fan_candidate& b) {
+			return a.distance_sq < b.distance_sq;
+		}
+	);
+
+	for (std::size_t i = 0; i < destinations_meters.size(); ++i) {
+		const auto p2 = b2Vec2(destinations_meters[i]);
+		const auto d = p2 - p1;
+		const auto length_sq = d.LengthSquared();
+
+		auto& output = outputs[i];
+
+		if (!(length_sq > 0.f)) {
+			continue;
+		}
+
+		b2RayCastInput input;
+		input.p1 = p1;
+		input.p2 = p2;
+		input.maxFraction = 1.0f;
+
+		for (const auto& c : candidates) {
+			if (c.distance_sq > input.maxFraction * input.maxFraction * length_sq) {
+				break;
+			}
+
+			if (!segment_overlaps_aabb(p1, d, input.maxFraction, c.aabb)) {
+				continue;
+			}
+
+			b2RayCastOutput hit;
+
+			if (c.fixture->RayCast(&hit, input, c.child_index)) {
+				const auto fraction = hit.fraction;
+
+				input.maxFraction = fraction;
+
+				output.intersection = (1.0f - fraction) * p1 + fraction * p2;
+				output.hit = true;
+				output.what_entity = c.fixture->GetBody()->GetUserData();
+				output.what_fixture = const_cast<b2Fixture*>(c.fixture);
+				output.normal = hit.normal;
+			}
+		}
+	}
+}
+
 physics_raycast_output physics_world_cache::ray_cast_px(
 	const si_scaling si,
 	const vec2 p1, 
@@ -158,4 +331,133 @@ physics_raycast_output physics_world_cache::ray_cast_px(
 	out.intersection = si.get_pixels(out.intersection);
 
 	return out;
-}
\ No newline at end of file
+}
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/misc/timing/timer.h"
+#include "augs/log.h"
+
+/* 
+	Casts fans like the visibility system does - at the vertices around a light -
+	checks that they hit exactly what single ray casts hit and logs the cost of both.
+*/
+
+static void check_ray_cast_fans(const int num_bodies, const int num_lights) {
+	uint32_t seed = 2137;
+
+	auto next_random = [&seed](const float lo, const float hi) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return lo + (hi - lo) * float(seed % 10000) / 10000.f;
+	};
+
+	const auto world_size = 200.f;
+	const auto light_range = 20.f;
+
+	physics_world_cache physics;
+	auto& world = *physics.b2world;
+
+	std::vector<vec2> vertices;
+
+	for (int i = 0; i < num_bodies; ++i) {
+		b2BodyDef def;
+		def.type = b2_staticBody;
+		def.transform.p.Set(next_random(0.f, world_size), next_random(0.f, world_size));
+		def.transform.q.Set(next_random(0.f, 6.28f));
+
+		auto& body = *world.CreateBody(&def);
+
+		if (i % 5 == 0) {
+			b2CircleShape circle;
+			circle.m_radius = next_random(0.2f, 1.f);
+			body.CreateFixture(&circle, 0.f);
+		}
+		else {
+			b2PolygonShape box;
+			box.SetAsBox(next_random(0.2f, 2.f), next_random(0.2f, 2.f));
+			body.CreateFixture(&box, 0.f);
+
+			for (int v = 0; v < box.GetVertexCount(); ++v) {
+				vertices.emplace_back(b2Mul(def.transform, box.GetVertex(v)));
+			}
+		}
+	}
+
+	std::vector<vec2> fan;
+	std::vector<physics_raycast_output> fan_outputs;
+	std::vector<physics_raycast_output> single_outputs;
+
+	double single_ms = 0.0;
+	double fan_ms = 0.0;
+	std::size_t total_rays = 0;
+
+	for (int l = 0; l < num_lights; ++l) {
+		const auto eye = vec2(next_random(0.f, world_size), next_random(0.f, world_size));
+
+		fan.clear();
+
+		for (const auto& v : vertices) {
+			if (std::abs(v.x - eye.x) < light_range && std::abs(v.y - eye.y) < light_range) {
+				const auto dir = v - eye;
+
+				/* Like the epsilon rays, slightly beside the vertex and past it. */
+				fan.push_back(eye + dir * 1.5f);
+				fan.push_back(eye + (dir + dir.perpendicular_cw() * 0.01f) * 1.5f);
+				fan.push_back(eye + (dir - dir.perpendicular_cw() * 0.01f) * 1.5f);
+			}
+		}
+
+		fan.push_back(eye);
+		total_rays += fan.size();
+
+		{
+			augs::timer t;
+
+			single_outputs.clear();
+
+			for (const auto& d : fan) {
+				single_outputs.push_back(physics.ray_cast(eye, d, b2Filter()));
+			}
+
+			single_ms += t.get<std::chrono::microseconds>() / 1000.0;
+		}
+
+		{
+			augs::timer t;
+			physics.ray_cast_fan(eye, fan, b2Filter(), fan_outputs);
+			fan_ms += t.get<std::chrono::microseconds>() / 1000.0;
+		}
+
+		REQUIRE(fan_outputs.size() == single_outputs.size());
+
+		for (std::size_t i = 0; i < fan.size(); ++i) {
+			const auto& a = single_outputs[i];
+			const auto& b = fan_outputs[i];
+
+			REQUIRE(a.hit == b.hit);
+			REQUIRE(a.what_fixture == b.what_fixture);
+			REQUIRE(a.intersection == b.intersection);
+			REQUIRE(a.normal == b.normal);
+		}
+	}
+
+	LOG(
+		"%x bodies, %x rays per light: single ray casts %x ms, fan %x ms per light", 
+		num_bodies, 
+		total_rays / num_lights, 
+		single_ms / num_lights, 
+		fan_ms / num_lights
+	);
+}
+
+TEST_CASE("PhysicsWorldCache RayCastFan") {
+	check_ray_cast_fans(100, 10);
+}
+
+TEST_CASE("PhysicsWorldCache RayCastFanCost", "[.bench]") {
+	for (const int num_bodies : { 1000, 5000 }) {
+		check_ray_cast_fans(num_bodies, 50);
+	}
+}
+#endif
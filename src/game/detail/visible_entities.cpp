@@ -272,9 +272,10 @@ void visible_entities::acquire_non_physical(const visible_entities_query input)
 			organisms.for_each_cell_of_all_grids(
 				camera.get_visible_world_rect_aabb(),
 				[&](const auto& cell) {
-					for (const auto& o : cell.organisms) {
+					cell.for_each_organism([&](const auto o) {
 						add_visible(o);
-					}
+						return callback_result::CONTINUE;
+					});
 				}
 			);
 		}
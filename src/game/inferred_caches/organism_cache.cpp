@@ -7,7 +7,7 @@
 
 void organism_cache::grid::erase_organism(const organism_id_type id) {
 	for (auto& cell : cells) {
-		erase_element(cell.organisms, id);
+		erase_organism_from(cell, id);
 	}
 }
 
@@ -20,9 +20,12 @@ void organism_cache::erase_organism(const organism_id_type id) {
 void organism_cache::grid::clear() {
 	aabb = {};
 
-	for (auto& v : cells) {
-		v.organisms.clear();
+	for (auto& c : cells) {
+		c = {};
 	}
+
+	nodes.clear();
+	first_free = no_node;
 }
 
 void organism_cache::grid::reset(const ltrb new_aabb) {
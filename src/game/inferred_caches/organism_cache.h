@@ -14,12 +14,46 @@ public:
 private:
 
 	struct grid {
+		/*
+			Every cell is a list of organisms threaded through one contiguous buffer of nodes,
+			so moving an organism to another cell never allocates
+			and the whole grid is copied as a few flat buffers.
+
+			Organisms of a cell are kept in the order of their insertion,
+			since flocking only considers the first few organisms of each cell.
+		*/
+
+		using node_index = uint32_t;
+		static constexpr node_index no_node = static_cast<node_index>(-1);
+
+		struct node {
+			organism_id_type id;
+			node_index next = no_node;
+			node_index prev = no_node;
+		};
+
 		struct cell {
-			std::vector<organism_id_type> organisms;
+			node_index head = no_node;
+			node_index tail = no_node;
+			uint32_t count = 0;
+		};
+
+		struct cell_view {
+			const grid& owner;
+			const cell& viewed;
+
+			auto size() const {
+				return viewed.count;
+			}
+
+			template <class F>
+			void for_each_organism(F callback) const;
 		};
 
 		ltrb aabb;
 		std::vector<cell> cells;
+		std::vector<node> nodes;
+		node_index first_free = no_node;
 
 		void reset(ltrb aabb);
 		void clear();
@@ -38,6 +72,9 @@ private:
 		template <class F>
 		void for_each_cell(const ltrb query, F callback) const;
 
+		void push_organism(cell&, organism_id_type);
+		bool erase_organism_from(cell&, organism_id_type);
+
 		void erase_organism_from_position(organism_id_type, vec2);
 		void erase_organism(organism_id_type);
 	};
@@ -55,6 +92,7 @@ private:
 
 public:
 	using cell_type = grid::cell;
+	using cell_view_type = grid::cell_view;
 	using grid_type = grid;
 
 	template <class E>
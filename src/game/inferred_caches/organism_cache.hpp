@@ -35,8 +35,7 @@ bool organism_cache::assign_to_grid(const E& organism) {
 	if (const auto t = organism.find_logic_transform()) {
 		const auto p = t->pos;
 
-		auto& cell = grid.get_cell_at_world(p);
-		cell.organisms.emplace_back(organism.get_id());
+		grid.push_organism(grid.get_cell_at_world(p), organism.get_id());
 
 		return true;
 	}
@@ -102,9 +101,7 @@ inline bool organism_cache::recalculate_cell_for(
 ) {
 	if (const auto grid = find_grid(origin)) {
 		grid->erase_organism_from_position(organism_id, old_position);
-
-		auto& new_orgs = grid->get_cell_at_world(new_position).organisms;
-		new_orgs.emplace_back(organism_id);
+		grid->push_organism(grid->get_cell_at_world(new_position), organism_id);
 
 		return true;
 	}
@@ -151,13 +148,69 @@ inline bool organism_cache::grid::is_set() const {
 	return aabb.good();
 }
 
-inline void organism_cache::grid::erase_organism_from_position(const organism_id_type id, const vec2 pos) {
-	auto& old_orgs = get_cell_at_world(pos).organisms;
+inline void organism_cache::grid::push_organism(cell& c, const organism_id_type id) {
+	node_index n = first_free;
+
+	if (n != no_node) {
+		first_free = nodes[n].next;
+		nodes[n] = node { id };
+	}
+	else {
+		n = static_cast<node_index>(nodes.size());
+		nodes.push_back(node { id });
+	}
 
-	const auto before_size = old_orgs.size();
-	erase_element(old_orgs, id);
+	nodes[n].prev = c.tail;
 
-	if (old_orgs.size() == before_size) {
+	if (c.tail != no_node) {
+		nodes[c.tail].next = n;
+	}
+	else {
+		c.head = n;
+	}
+
+	c.tail = n;
+	++c.count;
+}
+
+inline bool organism_cache::grid::erase_organism_from(cell& c, const organism_id_type id) {
+	bool erased = false;
+
+	for (auto n = c.head; n != no_node; ) {
+		auto& nd = nodes[n];
+		const auto next = nd.next;
+
+		if (nd.id == id) {
+			if (nd.prev != no_node) {
+				nodes[nd.prev].next = next;
+			}
+			else {
+				c.head = next;
+			}
+
+			if (next != no_node) {
+				nodes[next].prev = nd.prev;
+			}
+			else {
+				c.tail = nd.prev;
+			}
+
+			--c.count;
+
+			nd.next = first_free;
+			first_free = n;
+
+			erased = true;
+		}
+
+		n = next;
+	}
+
+	return erased;
+}
+
+inline void organism_cache::grid::erase_organism_from_position(const organism_id_type id, const vec2 pos) {
+	if (!erase_organism_from(get_cell_at_world(pos), id)) {
 		erase_organism(id);
 	}
 }
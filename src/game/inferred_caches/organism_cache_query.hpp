@@ -1,4 +1,5 @@
 #pragma once
+#include "augs/enums/callback_result.h"
 #include "game/inferred_caches/organism_cache.h"
 
 template <class F>
@@ -12,12 +13,24 @@ void organism_cache::grid::for_each_cell(const ltrb query, F callback) const {
 
 	for (int y = lt_bound.y; y <= rb_bound.y; ++y) {
 		for (int x = lt_bound.x; x <= rb_bound.x; ++x) {
-			auto& c = get_cell({ x, y });
-			callback(c);
+			callback(cell_view { *this, get_cell({ x, y }) });
 		}
 	}
 }
 
+template <class F>
+void organism_cache::grid::cell_view::for_each_organism(F callback) const {
+	for (auto n = viewed.head; n != no_node; ) {
+		const auto& nd = owner.nodes[n];
+
+		if (callback(nd.id) == callback_result::ABORT) {
+			return;
+		}
+
+		n = nd.next;
+	}
+}
+
 template <class F>
 void organism_cache::for_each_cell_of_grid(const unversioned_entity_id origin, const ltrb query, F&& callback) const {
 	if (const auto grid = find_grid(origin)) {
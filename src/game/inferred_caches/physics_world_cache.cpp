@@ -2,13 +2,10 @@
 #include "3rdparty/Box2D/Box2D.h"
 
 #include <cstring>
-#include <unordered_set>
 
 #include "3rdparty/Box2D/Box2D.h"
 #include "physics_world_cache.h"
 
-#include "augs/build_settings/offsetof.h"
-
 #include "game/components/item_component.h"
 #include "game/components/driver_component.h"
 #include "game/components/fixtures_component.h"
@@ -27,7 +24,6 @@
 #include "game/cosmos/logic_step.h"
 #include "game/cosmos/entity_handle.h"
 
-#include "augs/templates/dynamic_cast_dispatch.h"
 #include "augs/build_settings/setting_debug_physics_world_cache_copy.h"
 #include "game/detail/entity_handle_mixins/get_owning_transfer_capability.hpp"
 #include "game/enums/filters.h"
@@ -205,17 +201,18 @@ physics_world_cache& physics_world_cache::operator=(const physics_world_cache&)
 	return *this;
 }
 
-void physics_world_cache::clone_from(const physics_world_cache& source_cache, cosmos& target_cosm, const cosmos& source_cosm) {
-	ensure(std::addressof(target_cosm) != std::addressof(source_cosm));
-	ensure(this != std::addressof(source_cache));
+/*
+	Every body, fixture, shape, proxy, contact and joint lives in the blocks of b2BlockAllocator.
+	Instead of allocating and copying them one by one,
+	the allocator copies its chunks wholesale and every stored pointer is rebased
+	from the source chunk it points into to the corresponding target chunk.
 
-	accumulated_messages = source_cache.accumulated_messages;
+	Edges of contacts and joints are embedded in the objects that own them,
+	so they are rebased just like any other pointer.
+*/
 
-	b2World& migrated_b2World = *b2world.get();
-	migrated_b2World.~b2World();
-	new (&migrated_b2World) b2World(b2Vec2(0.f, 0.f));
-
-	const b2World& source_b2World = *source_cache.b2world.get();
+void physics_world_cache::clone_b2World(b2World& migrated_b2World, const b2World& source_b2World) {
+	ensure(std::addressof(migrated_b2World) != std::addressof(source_b2World));
 
 #if DEBUG_PHYSICS_SYSTEM_COPY
 	ensure_eq(0, source_b2World.m_stackAllocator.m_entryCount);
@@ -224,16 +221,17 @@ void physics_world_cache::clone_from(const physics_world_cache& source_cache, co
 
 	ensure_eq(static_cast<const b2ContactListener*>(source_b2World.m_contactManager.m_contactListener), &source_b2World.defaultListener);
 
-	// do the initial trivial copy of all fields,
-	// we will migrate all pointers shortly
+	/*
+		b2BlockAllocator has a null operator=, so the target keeps its own chunks,
+		which CloneFrom will reuse.
+
+		The previous contents of the target need no destruction:
+		shapes used by the game do not allocate outside of the block allocator.
+	*/
+
 	migrated_b2World = source_b2World;
 
 	{
-#if DEBUG_PHYSICS_SYSTEM_COPY
-		ensure_eq(0, migrated_b2World.m_stackAllocator.m_entryCount);
-		ensure_eq(0, migrated_b2World.m_stackAllocator.m_index);
-#endif
-
 		b2StackEntry null_entry;
 		null_entry.data = nullptr;
 
@@ -241,290 +239,120 @@ void physics_world_cache::clone_from(const physics_world_cache& source_cache, co
 		std::fill(std::begin(entries), std::end(entries), null_entry);
 	}
 
-	/*
-	   	b2BlockAllocator has a null operator=, 
-		so the migrated_b2World preserves its default-constructed allocator even after the above copy. 
-
-		We don't even need to do this:
-
-		new (&migrated_b2World.m_blockAllocator) b2BlockAllocator;
-	*/
+	b2BlockAllocator& migrated_allocator = migrated_b2World.m_blockAllocator;
+	migrated_allocator.CloneFrom(source_b2World.m_blockAllocator);
 
-	// reset the allocator pointer to the new one
-	migrated_b2World.m_contactManager.m_allocator = &migrated_b2World.m_blockAllocator;
+	migrated_b2World.m_contactManager.m_allocator = &migrated_allocator;
 	migrated_b2World.m_contactManager.m_contactFilter = &migrated_b2World.defaultFilter;
 	migrated_b2World.m_contactManager.m_contactListener = &migrated_b2World.defaultListener;
 
-	std::unordered_map<const void*, void*> pointer_migrations;
-	std::unordered_map<const void*, bool> contact_edge_a_or_b_in_contacts;
-	std::unordered_map<const void*, bool> joint_edge_a_or_b_in_joints;
-
-	b2BlockAllocator& migrated_allocator = migrated_b2World.m_blockAllocator;
-
-	const auto contact_edge_a_offset = augs_offsetof(b2Contact, m_nodeA);
-	const auto contact_edge_b_offset = augs_offsetof(b2Contact, m_nodeB);
-
-	const auto joint_edge_a_offset = augs_offsetof(b2Joint, m_edgeA);
-	const auto joint_edge_b_offset = augs_offsetof(b2Joint, m_edgeB);
-
-#if DEBUG_PHYSICS_SYSTEM_COPY
-	std::unordered_set<void**> already_migrated_pointers;
-#endif
-
-	auto migrate_pointer = [
-#if DEBUG_PHYSICS_SYSTEM_COPY
-		&already_migrated_pointers, 
-#endif
-		&pointer_migrations, 
-		&migrated_allocator
-	](
-		auto*& pointer_to_be_migrated, 
-		const unsigned count = 1
-	) {
-#if DEBUG_PHYSICS_SYSTEM_COPY
-		ensure(already_migrated_pointers.find(reinterpret_cast<void**>(&pointer_to_be_migrated)) == already_migrated_pointers.end());
-		already_migrated_pointers.insert(reinterpret_cast<void**>(&pointer_to_be_migrated));
-#endif
-
-		using type = std::remove_pointer_t<std::remove_reference_t<decltype(pointer_to_be_migrated)>>;
-		static_assert(!std::is_same_v<type, b2Joint>, "Can't migrate an abstract base class");
-
-		const auto void_ptr = reinterpret_cast<const void*>(pointer_to_be_migrated);
-
-		if (pointer_to_be_migrated == nullptr) {
+	auto rebase = [&migrated_allocator](auto*& p) {
+		if (p == nullptr) {
 			return;
 		}
 
-		if (
-			auto maybe_already_migrated = pointer_migrations.find(void_ptr);
-			maybe_already_migrated == pointer_migrations.end()
-		) {
-			const auto bytes_count = std::size_t{ sizeof(type) * count };
-
-			void* const migrated_pointer = migrated_allocator.Allocate(static_cast<int32>(bytes_count));
-			std::memcpy(migrated_pointer, void_ptr, bytes_count);
-			
-			/* Bookmark position in memory of each and every element */
-
-			pointer_migrations.insert(std::make_pair(
-				void_ptr, 
-				migrated_pointer
-			));
-			
-			pointer_to_be_migrated = reinterpret_cast<type*>(migrated_pointer);
-		}
-		else {
-			pointer_to_be_migrated = reinterpret_cast<type*>((*maybe_already_migrated).second);
-		}
-	};
-
-	// migration of contacts and contact edges
-	
-	auto migrate_contact_edge = [
-#if DEBUG_PHYSICS_SYSTEM_COPY
-		&already_migrated_pointers,
-#endif
-		&pointer_migrations, 
-		&contact_edge_a_or_b_in_contacts,
-		contact_edge_a_offset,
-		contact_edge_b_offset
-	](b2ContactEdge*& edge_ptr) {
-#if DEBUG_PHYSICS_SYSTEM_COPY
-		ensure(already_migrated_pointers.find((void**)&edge_ptr) == already_migrated_pointers.end());
-		already_migrated_pointers.insert((void**)&edge_ptr);
-#endif
-		if (edge_ptr == nullptr) {
-			return;
-		}
-
-		const bool a_or_b_in_contact { contact_edge_a_or_b_in_contacts.at(edge_ptr) };
-		const auto offset_to_edge_in_contact = std::size_t{ !a_or_b_in_contact ? contact_edge_a_offset : contact_edge_b_offset };
+		auto* const rebased = migrated_allocator.Rebase(p);
 
-		std::byte* const contact_that_owns_unmigrated_edge = reinterpret_cast<std::byte*>(edge_ptr) - offset_to_edge_in_contact;
-		// here "at" requires that the contacts be already migrated
-		std::byte* const migrated_contact = reinterpret_cast<std::byte*>(pointer_migrations.at(contact_that_owns_unmigrated_edge));
-		std::byte* const edge_from_migrated_contact = migrated_contact + offset_to_edge_in_contact;
+		/* Would mean that something was allocated past b2_maxBlockSize. */
+		ensure(rebased != nullptr);
 
-		edge_ptr = reinterpret_cast<b2ContactEdge*>(edge_from_migrated_contact);
+		p = rebased;
 	};
 
-	// make a map of pointers to b2ContactEdges to their respective offsets in
-	// the b2Contacts that own them
-	for (b2Contact* c = migrated_b2World.m_contactManager.m_contactList; c; c = c->m_next) {
-		contact_edge_a_or_b_in_contacts.insert(std::make_pair(&c->m_nodeA, false));
-		contact_edge_a_or_b_in_contacts.insert(std::make_pair(&c->m_nodeB, true));
-	}
-
-	// migrate contact pointers
-	// contacts are polymorphic, but their derived classes do not add any member fields.
-	// thus, it is safe to just memcpy sizeof(b2Contact)
+	auto rebase_edge = [&rebase](auto& edge) {
+		rebase(edge.other);
+		rebase(edge.prev);
+		rebase(edge.next);
+	};
 
-	migrate_pointer(migrated_b2World.m_contactManager.m_contactList);
+	rebase(migrated_b2World.m_contactManager.m_contactList);
 
 	for (b2Contact* c = migrated_b2World.m_contactManager.m_contactList; c; c = c->m_next) {
-		migrate_pointer(c->m_prev);
-		migrate_pointer(c->m_next);
-		migrate_pointer(c->m_fixtureA);
-		migrate_pointer(c->m_fixtureB);
-		
+		rebase(c->m_prev);
+		rebase(c->m_next);
+		rebase(c->m_fixtureA);
+		rebase(c->m_fixtureB);
+
 		c->m_nodeA.contact = c;
-		migrate_pointer(c->m_nodeA.other);
+		rebase_edge(c->m_nodeA);
 
 		c->m_nodeB.contact = c;
-		migrate_pointer(c->m_nodeB.other);
-	}
-
-	// migrate contact edges of contacts
-	for (b2Contact* c = migrated_b2World.m_contactManager.m_contactList; c; c = c->m_next) {
-		migrate_contact_edge(c->m_nodeA.next);
-		migrate_contact_edge(c->m_nodeA.prev);
-
-		migrate_contact_edge(c->m_nodeB.next);
-		migrate_contact_edge(c->m_nodeB.prev);
+		rebase_edge(c->m_nodeB);
 	}
-	
-	// migration of joints and joint edges
-
-	auto migrate_joint_edge = [
-#if DEBUG_PHYSICS_SYSTEM_COPY
-		&already_migrated_pointers,
-#endif
-		&pointer_migrations,
-		&joint_edge_a_or_b_in_joints,
-		joint_edge_a_offset,
-		joint_edge_b_offset
-	](b2JointEdge*& edge_ptr) {
-#if DEBUG_PHYSICS_SYSTEM_COPY
-		ensure(already_migrated_pointers.find((void**)&edge_ptr) == already_migrated_pointers.end());
-		already_migrated_pointers.insert((void**)&edge_ptr);
-#endif
-		if (edge_ptr == nullptr) {
-			return;
-		}
 
-		const bool a_or_b_in_joint { joint_edge_a_or_b_in_joints.at(edge_ptr) };
-		const auto offset_to_edge_in_joint = std::size_t { !a_or_b_in_joint ? joint_edge_a_offset : joint_edge_b_offset };
+	rebase(migrated_b2World.m_jointList);
 
-		std::byte* const joint_that_owns_unmigrated_edge = reinterpret_cast<std::byte*>(edge_ptr) - offset_to_edge_in_joint;
-		// here "at" requires that the joints be already migrated
-		std::byte* const migrated_joint = reinterpret_cast<std::byte*>(pointer_migrations.at(joint_that_owns_unmigrated_edge));
-		std::byte* const edge_from_migrated_joint = migrated_joint + offset_to_edge_in_joint;
-
-		edge_ptr = reinterpret_cast<b2JointEdge*>(edge_from_migrated_joint);
-	};
-
-	auto migrate_joint = [&migrate_pointer](b2Joint*& j){
-		if (j == nullptr) {
-			return;
-		}
-
-		dynamic_cast_dispatch<
-			b2MotorJoint, // most likely
-
-			b2DistanceJoint,
-			b2FrictionJoint,
-			b2GearJoint,
-			b2MouseJoint,
-			b2PrismaticJoint,
-			b2PulleyJoint,
-			b2RevoluteJoint,
-			b2RopeJoint,
-			b2WeldJoint,
-			b2WheelJoint
-		>(j, [&j, &migrate_pointer](auto* derived){
-			using derived_type = std::remove_pointer_t<decltype(derived)>;
-			// static_assert(std::is_same_v<derived_type, b2MotorJoint>, "test failed");
-			migrate_pointer(reinterpret_cast<derived_type*&>(j));
-		});
-	};
-
-	// make a map of pointers to b2JointEdges to their respective offsets in
-	// the b2Joints that own them
 	for (b2Joint* j = migrated_b2World.m_jointList; j; j = j->m_next) {
-		joint_edge_a_or_b_in_joints.insert(std::make_pair(&j->m_edgeA, false));
-		joint_edge_a_or_b_in_joints.insert(std::make_pair(&j->m_edgeB, true));
-	}
+		rebase(j->m_prev);
+		rebase(j->m_next);
+		rebase(j->m_bodyA);
+		rebase(j->m_bodyB);
 
-	// migrate joint pointers
-	migrate_joint(migrated_b2World.m_jointList);
+		j->m_edgeA.joint = j;
+		rebase_edge(j->m_edgeA);
 
-	for (b2Joint* c = migrated_b2World.m_jointList; c; c = c->m_next) {
-		migrate_joint(c->m_prev);
-		migrate_joint(c->m_next);
-		migrate_pointer(c->m_bodyA);
-		migrate_pointer(c->m_bodyB);
-
-		c->m_edgeA.joint = c;
-		migrate_pointer(c->m_edgeA.other);
-
-		c->m_edgeB.joint = c;
-		migrate_pointer(c->m_edgeB.other);
-	}
-
-	// migrate joint edges of joints
-	for (b2Joint* c = migrated_b2World.m_jointList; c; c = c->m_next) {
-		migrate_joint_edge(c->m_edgeA.next);
-		migrate_joint_edge(c->m_edgeA.prev);
-
-		migrate_joint_edge(c->m_edgeB.next);
-		migrate_joint_edge(c->m_edgeB.prev);
+		j->m_edgeB.joint = j;
+		rebase_edge(j->m_edgeB);
 	}
 
 	auto& proxy_tree = migrated_b2World.m_contactManager.m_broadPhase.m_tree;
 
-	// migrate bodies and fixtures
-	migrate_pointer(migrated_b2World.m_bodyList);
+	rebase(migrated_b2World.m_bodyList);
 
 	for (b2Body* b = migrated_b2World.m_bodyList; b; b = b->m_next) {
-		migrate_pointer(b->m_fixtureList);
-		migrate_pointer(b->m_prev);
-		migrate_pointer(b->m_next);
-		migrate_pointer(b->m_ownerFrictionGround);
+		rebase(b->m_prev);
+		rebase(b->m_next);
+		rebase(b->m_ownerFrictionGround);
+		rebase(b->m_fixtureList);
+		rebase(b->m_contactList);
+		rebase(b->m_jointList);
 
-		migrate_contact_edge(b->m_contactList);
-		migrate_joint_edge(b->m_jointList);
 		b->m_world = &migrated_b2World;
-		
-		/*
-			b->m_fixtureList is already migrated.
-			f->m_next will also be always migrated before the next iteration
-			thus f is always already a migrated instance.
-		*/
 
 		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next) {
 			f->m_body = b;
-			
-			migrate_pointer(f->m_proxies, f->m_proxyCount);
-			f->m_shape = f->m_shape->Clone(&migrated_allocator);
-			migrate_pointer(f->m_next);
 
-			for (std::size_t i = 0; i < f->m_proxyCount; ++i) {
-#if DEBUG_PHYSICS_SYSTEM_COPY
-				/* 
-					"fixture" field of b2FixtureProxy should point to the fixture itself,
-					thus its value should already be found in the pointer map. 
-				*/
+			rebase(f->m_next);
+			rebase(f->m_shape);
+			rebase(f->m_proxies);
 
-				ensure(pointer_migrations.find(f->m_proxies[i].fixture) != pointer_migrations.end())
-
-				{
-					const auto ff = pointer_migrations[f->m_proxies[i].fixture];
-					ensure_eq(reinterpret_cast<void*>(f), ff);
-				}
-#endif
+			for (int32 i = 0; i < f->m_proxyCount; ++i) {
 				f->m_proxies[i].fixture = f;
-				
-				void*& ud = proxy_tree.m_nodes[f->m_proxies[i].proxyId].userData;
-				ud = pointer_migrations.at(ud);
+
+				/*
+					The broadphase tree was copied by value, 
+					but the userdata of its leaves points to the fixture proxies.
+				*/
+
+				proxy_tree.m_nodes[f->m_proxies[i].proxyId].userData = &f->m_proxies[i];
 			}
 		}
 	}
 
-	/*
-		There is no need to iterate userdatas of the broadphase's dynamic tree,
-		as for every existing b2FixtureProxy we have manually migrated the correspondent userdata
-		inside the loop that migrated all bodies and fixtures.
-	*/
+#if DEBUG_PHYSICS_SYSTEM_COPY
+	ensure_eq(
+		migrated_allocator.m_numAllocatedObjects, 
+		source_b2World.m_blockAllocator.m_numAllocatedObjects
+	);
+#endif
+}
+
+std::size_t physics_world_cache::get_allocated_bytes() const {
+	return static_cast<std::size_t>(b2world->m_blockAllocator.GetChunkCount()) * b2_chunkSize;
+}
+
+void physics_world_cache::clone_from(const physics_world_cache& source_cache, cosmos& target_cosm, const cosmos& source_cosm) {
+	ensure(std::addressof(target_cosm) != std::addressof(source_cosm));
+	ensure(this != std::addressof(source_cache));
+
+	accumulated_messages = source_cache.accumulated_messages;
+
+	b2World& migrated_b2World = *b2world.get();
+	const b2World& source_b2World = *source_cache.b2world.get();
+
+	clone_b2World(migrated_b2World, source_b2World);
+
+	const b2BlockAllocator& migrated_allocator = migrated_b2World.m_blockAllocator;
 
 	target_cosm.for_each_having<invariants::fixtures>(
 		[&](const auto& typed_collider) {
@@ -542,9 +370,7 @@ void physics_world_cache::clone_from(const physics_world_cache& source_cache, co
 						const auto& source_cache = get_corresponding<colliders_cache>(source_entity);
 
 						for (const auto& f : source_cache.constructed_fixtures) {
-							migrated_cache.constructed_fixtures.emplace_back(
-								reinterpret_cast<b2Fixture*>(pointer_migrations.at(reinterpret_cast<const void*>(f.get())))
-							);
+							migrated_cache.constructed_fixtures.emplace_back(migrated_allocator.Rebase(f.get()));
 						}
 					}
 
@@ -552,16 +378,10 @@ void physics_world_cache::clone_from(const physics_world_cache& source_cache, co
 						auto& migrated_cache = migrated_rigid_cache;
 
 						const auto& source_cache = get_corresponding<rigid_body_cache>(source_entity);
-						const auto b_body = source_cache.body.get();
 
 						static_assert(sizeof(migrated_cache) == sizeof(augs::propagate_const<b2Body*>));
 
-						if (b_body) {
-							migrated_cache.body = reinterpret_cast<b2Body*>(pointer_migrations.at(reinterpret_cast<const void*>(b_body)));
-						}
-						else {
-							migrated_cache.body = nullptr;
-						}
+						migrated_cache.body = migrated_allocator.Rebase(source_cache.body.get());
 					}
 				}
 			);
@@ -576,17 +396,91 @@ void physics_world_cache::clone_from(const physics_world_cache& source_cache, co
 		const auto b_joint = source_cache.joint_caches[it.first].joint.get();
 
 		if (b_joint) {
-			joint_caches[i].joint = reinterpret_cast<b2Joint*>(pointer_migrations.at(reinterpret_cast<const void*>(b_joint)));
+			joint_caches[i].joint = migrated_allocator.Rebase(b_joint);
 		}
 	}
 #endif
+}
 
-#if DEBUG_PHYSICS_SYSTEM_COPY
-	// ensure that all allocations have been migrated
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/misc/timing/timer.h"
+#include "augs/log.h"
 
-	ensure_eq(
-		migrated_allocator.m_numAllocatedObjects, 
-		source_b2World.m_blockAllocator.m_numAllocatedObjects
-	);
-#endif
+/* Logs the cost of a clone and checks that the clone steps exactly like the source. */
+
+static void check_b2World_clone(const int num_bodies, const int num_clones) {
+	auto populate = [num_bodies](b2World& world) {
+		b2PolygonShape box;
+		box.SetAsBox(0.5f, 0.5f);
+
+		b2FixtureDef fixture_def;
+		fixture_def.shape = &box;
+		fixture_def.density = 1.f;
+
+		for (int i = 0; i < num_bodies; ++i) {
+			b2BodyDef def;
+			def.type = b2_dynamicBody;
+
+			/* Slightly overlapping so that there are contacts to clone. */
+			def.transform.p.Set((i % 50) * 0.9f, (i / 50) * 0.9f);
+			def.linearVelocity.Set(float(i % 7) - 3.f, float(i % 5) - 2.f);
+
+			world.CreateBody(&def)->CreateFixture(&fixture_def);
+		}
+	};
+
+	auto make_world = []() {
+		auto world = std::make_unique<b2World>(b2Vec2(0.f, 0.f));
+		world->SetAllowSleeping(true);
+		world->SetAutoClearForces(false);
+		return world;
+	};
+
+	const auto dt = 1 / 60.f;
+
+	auto source = make_world();
+	auto target = make_world();
+
+	populate(*source);
+	source->Step(dt, 8, 3);
+
+	augs::timer cloning;
+
+	for (int i = 0; i < num_clones; ++i) {
+		physics_world_cache::clone_b2World(*target, *source);
+	}
+
+	LOG("Cloning a b2World with %x bodies: %x ms", num_bodies, cloning.get<std::chrono::milliseconds>() / num_clones);
+
+	REQUIRE(target->GetBodyCount() == source->GetBodyCount());
+	REQUIRE(target->GetContactCount() == source->GetContactCount());
+	REQUIRE(target->GetContactCount() > 0);
+
+	for (int step = 0; step < 10; ++step) {
+		source->Step(dt, 8, 3);
+		target->Step(dt, 8, 3);
+	}
+
+	for (
+		const b2Body* s = source->GetBodyList(), *t = target->GetBodyList();
+		s || t;
+		s = s->GetNext(), t = t->GetNext()
+	) {
+		REQUIRE(s != nullptr);
+		REQUIRE(t != nullptr);
+		REQUIRE(s->GetPosition() == t->GetPosition());
+		REQUIRE(s->GetLinearVelocity() == t->GetLinearVelocity());
+	}
+}
+
+TEST_CASE("PhysicsWorldCache Clone") {
+	check_b2World_clone(100, 2);
 }
+
+TEST_CASE("PhysicsWorldCache CloneCost", "[.bench]") {
+	for (const int num_bodies : { 1000, 5000 }) {
+		check_b2World_clone(num_bodies, 20);
+	}
+}
+#endif
@@ -77,6 +77,12 @@ public:
 
 	void clone_from(const physics_world_cache& source_world, cosmos& target_cosmos, const cosmos& source_cosmos);
 
+	/* Makes the target an exact copy of the source without reconstructing any bodies. */
+	static void clone_b2World(b2World& target, const b2World& source);
+
+	/* Memory held by the chunks of the b2World block allocator. */
+	std::size_t get_allocated_bytes() const;
+
 	std::vector<physics_raycast_output> ray_cast_all_intersections(
 		const vec2 p1_meters,
 		const vec2 p2_meters, 
@@ -91,6 +97,20 @@ public:
 		const entity_id ignore_entity = entity_id()
 	) const;
 
+	/*
+		Casts rays from a common origin to every destination, 
+		querying the broadphase only once for the whole fan.
+		Writes one output per destination, the same as ray_cast would return.
+	*/
+
+	void ray_cast_fan(
+		const vec2 origin_meters,
+		const std::vector<vec2>& destinations_meters,
+		const b2Filter filter,
+		std::vector<physics_raycast_output>& outputs,
+		const entity_id ignore_entity = entity_id()
+	) const;
+
 	physics_raycast_output ray_cast_px(
 		const si_scaling si,
 		const vec2 p1, 
@@ -123,15 +123,16 @@ void movement_path_system::advance_paths(const logic_step step) const {
 					constexpr auto max_handled_organisms = std::size_t(3);
 
 					auto cell_callback = [&](const auto& cell) {
-						const auto& orgs = cell.organisms;
-						const auto cnt = std::min(orgs.size(), max_handled_organisms);
+						std::size_t handled_organisms = 0;
 
-						for (std::size_t i = 0; i < cnt; ++i) {
-							const auto org_id = orgs[i];
+						cell.for_each_organism([&](const auto org_id) {
+							if (handled_organisms++ == max_handled_organisms) {
+								return callback_result::ABORT;
+							}
 
 							if (org_id == subject.get_id()) {
 								/* Don't measure against itself */
-								continue;
+								return callback_result::CONTINUE;
 							}
 
 							const auto typed_neighbor = cosm[org_id];
@@ -150,7 +151,9 @@ void movement_path_system::advance_paths(const logic_step step) const {
 							if (facing >= fov_half_degrees_cos) {
 								callback(typed_neighbor, neighbor_transform, neighbor_tip);
 							}
-						}
+
+							return callback_result::CONTINUE;
+						});
 					};
 
 					grids.for_each_cell_of_grid(
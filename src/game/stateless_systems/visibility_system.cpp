@@ -211,10 +211,6 @@ void visibility_system::calc_visibility(
 	/* we'll need a reference to physics system for raycasting */
 	const auto& physics = cosm.get_solvable_inferred().physics;
 
-	struct ray_input {
-		vec2 destination;
-	};
-
 	using ray_output = physics_raycast_output;
 
 	const auto ignored_entity = request.subject;
@@ -536,10 +532,10 @@ void visibility_system::calc_visibility(
 		lines.emplace_back(si.get_pixels(eye_meters), si.get_pixels(point), col);
 	};
 
-	thread_local std::vector<ray_input> all_ray_inputs;
+	thread_local std::vector<vec2> all_ray_destinations;
 
-	all_ray_inputs.clear();
-	all_ray_inputs.reserve(all_vertices_transformed.size());
+	all_ray_destinations.clear();
+	all_ray_destinations.reserve(all_vertices_transformed.size());
 
 	/* for every vertex to cast the ray to */
 	for (const auto& vertex : all_vertices_transformed) {
@@ -579,35 +575,30 @@ void visibility_system::calc_visibility(
 			}
 		}
 
-		ray_input new_ray_input;
-		new_ray_input.destination = vertex.is_on_a_bound ? vertex.pos : destination;
+		const auto ray_destination = vertex.is_on_a_bound ? vertex.pos : destination;
 
 #if LOG_VISIBILITY
 		{
 			const auto i = index_in(all_vertices_transformed, vertex);
-			VIS_LOG_NVPS(i, si.get_pixels(new_ray_input.destination), vertex.is_on_a_bound);
+			VIS_LOG_NVPS(i, si.get_pixels(ray_destination), vertex.is_on_a_bound);
 		}
 #endif
 
-		all_ray_inputs.push_back(new_ray_input);
+		all_ray_destinations.push_back(ray_destination);
 	}
 
 	thread_local std::vector<ray_output> all_ray_outputs;
 
-	all_ray_outputs.clear();
-	all_ray_outputs.reserve(all_vertices_transformed.size());
-
-	/* All raycast inputs are processed at once to improve cache coherency. */
-	for (std::size_t j = 0; j < all_ray_inputs.size(); ++j) {
-		auto result = physics.ray_cast(eye_meters, all_ray_inputs[j].destination, request.filter, ignored_entity);
-		all_ray_outputs.emplace_back(std::move(result));
+	/* All rays share the eye as their origin, so the broadphase is queried once for all of them. */
+	physics.ray_cast_fan(eye_meters, all_ray_destinations, request.filter, all_ray_outputs, ignored_entity);
 
 #if LOG_VISIBILITY
-		if (DEBUG_DRAWING.draw_cast_rays) {
-			draw_line(all_ray_inputs[j].destination, pink);
+	if (DEBUG_DRAWING.draw_cast_rays) {
+		for (const auto& d : all_ray_destinations) {
+			draw_line(d, pink);
 		}
-#endif
 	}
+#endif
 
 	for (std::size_t i = 0; i < all_ray_outputs.size(); ++i) {
 		const auto& ray_callback = all_ray_outputs[i];
@@ -756,7 +747,7 @@ void visibility_system::calc_visibility(
 				for (const auto& bound : visibility_bounds) {
 					const auto ray_edge_output = segment_segment_intersection(
 						eye_meters, 
-						all_ray_inputs[i].destination,
+						all_ray_destinations[i],
 						bound.m_vertex1, 
 						bound.m_vertex2
 					);
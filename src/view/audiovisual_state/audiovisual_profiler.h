@@ -11,10 +11,13 @@ struct audiovisual_profiler : public augs::profiler_mixin<audiovisual_profiler>
 	augs::time_measurements advance_particle_streams;
 	augs::time_measurements wandering_pixels;
 	augs::time_measurements sound_logic;
+	augs::time_measurements audio_command_latency;
 
 	augs::time_measurements post_solve;
 	augs::time_measurements post_cleanup;
 
 	augs::amount_measurements<std::size_t> num_particles = 1;
+	augs::amount_measurements<std::size_t> audio_queue_depth = 1;
+	augs::amount_measurements<std::size_t> num_coalesced_audio_commands = 1;
 	// END GEN INTROSPECTOR
 };
\ No newline at end of file
@@ -342,6 +342,17 @@ void audiovisual_state::advance(const audiovisual_advance_input input) {
 	if (should_update_audio) {
 		input.pool.enqueue(audio_job);
 	}
+
+	{
+		const auto audio_stats = input.command_buffers.take_stats();
+
+		performance.audio_queue_depth.measure(audio_stats.max_queue_depth);
+		performance.num_coalesced_audio_commands.measure(audio_stats.num_coalesced);
+
+		if (audio_stats.num_performed_batches > 0) {
+			performance.audio_command_latency.measure(audio_stats.max_latency_secs);
+		}
+	}
 }
 
 void audiovisual_state::spread_past_infection(const const_logic_step step) {
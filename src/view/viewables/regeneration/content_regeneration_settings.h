@@ -7,5 +7,10 @@ struct content_regeneration_settings {
 
 	unsigned atlas_blitting_threads = 2;
 	unsigned neon_regeneration_threads = 2;
+
+	bool cache_atlases = true;
+	unsigned max_cached_atlases = 8;
+
+	float stream_sounds_longer_than_secs = 20.f;
 	// END GEN INTROSPECTOR
 };
\ No newline at end of file
@@ -18,8 +18,11 @@ void regenerate_desaturation(
 	const augs::path_type& output_path,
 	const bool force_regenerate
 ) try {
+	/* The contents are hashed so that copying or touching the file does not force regeneration. */
+	const auto source_bytes = augs::file_to_bytes(source_path);
+
 	desaturation_stamp new_stamp;
-	new_stamp.last_write_time_of_source = last_write_time(source_path);
+	new_stamp.source_hash = augs::secure_hash(source_bytes);
 
 	const auto desaturation_stamp_path = augs::path_type(output_path).replace_extension(".stamp");
 
@@ -48,7 +51,7 @@ void regenerate_desaturation(
 		LOG("Regenerating desaturation for %x", source_path);
 
 		augs::image input_image;
-		input_image.from_file(source_path);
+		input_image.from_bytes(source_bytes, source_path);
 		input_image.desaturate().save(output_path);
 
 		augs::create_directories_for(desaturation_stamp_path);
@@ -1,14 +1,13 @@
 #pragma once
 #include <vector>
-#include <chrono>
 
 #include "augs/graphics/rgba.h"
 #include "augs/filesystem/path.h"
-#include "augs/filesystem/file_time_type.h"
+#include "augs/misc/secure_hash.h"
 
 struct desaturation_stamp {
 	// GEN INTROSPECTOR struct desaturation_stamp
-	augs::file_time_type last_write_time_of_source;
+	augs::secure_hash_type source_hash;
 	// END GEN INTROSPECTOR
 };
 
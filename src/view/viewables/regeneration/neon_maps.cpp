@@ -27,9 +27,10 @@ std::optional<cached_neon_map_in> should_regenerate_neon_map(
 	const neon_map_input in,
 	const bool force_regenerate
 ) try {
+	/* The contents are hashed so that copying or touching the file does not force regeneration. */
 	neon_map_stamp new_stamp;
 	new_stamp.input = in;
-	new_stamp.last_write_time_of_source = augs::last_write_time(input_image_path);
+	new_stamp.source_hash = augs::secure_hash(augs::file_to_bytes(input_image_path));
 
 	const auto neon_map_path = output_image_path;
 	const auto neon_map_stamp_path = augs::path_type(neon_map_path).replace_extension(".stamp");
@@ -71,11 +72,13 @@ void regenerate_neon_map(
 	const augs::path_type& input_image_path,
 	const augs::path_type& output_image_path,
 	const neon_map_input in,
-	cached_neon_map_in cached_in
+	cached_neon_map_in
 ) try {
+	const auto source_bytes = augs::file_to_bytes(input_image_path);
+
 	neon_map_stamp new_stamp;
 	new_stamp.input = in;
-	new_stamp.last_write_time_of_source = augs::last_write_time(input_image_path);
+	new_stamp.source_hash = augs::secure_hash(source_bytes);
 
 	const auto neon_map_path = output_image_path;
 	const auto neon_map_stamp_path = augs::path_type(neon_map_path).replace_extension(".stamp");
@@ -84,22 +87,24 @@ void regenerate_neon_map(
 
 	thread_local augs::image source_image;
 	source_image.clear();
-	source_image.from_file(input_image_path);
+	source_image.from_bytes(source_bytes, input_image_path);
 
 	make_neon(in, source_image);
 
 	source_image.save(neon_map_path);
 
+	/* Describes the bytes that were actually used, even if the file changed since it was checked. */
 	augs::create_directories_for(neon_map_stamp_path);
-	augs::bytes_to_file(cached_in.new_stamp_bytes, neon_map_stamp_path);
+	augs::bytes_to_file(new_stamp_bytes, neon_map_stamp_path);
 }
 catch (...) {
 	augs::remove_file(output_image_path);
 }
 
 void generate_gauss_kernel(
-	const neon_map_input& input,
-	std::vector<double>& result
+	float standard_deviation,
+	unsigned size,
+	std::vector<float>& result
 );
 
 void scan_and_hide_undesired_pixels(
@@ -115,7 +120,35 @@ void resize_image(
 
 void cut_empty_edges(augs::image& source);
 
-/* Thread local usage actually makes this slower, I have no idea why. */
+/*
+	The strongest contribution of any light pixel decides the alpha,
+	and the color is the average of the light colors weighted by their contributions.
+*/
+
+struct neon_glow_planes {
+	std::vector<float> peak;
+	std::vector<float> weight;
+	std::vector<float> r;
+	std::vector<float> g;
+	std::vector<float> b;
+
+	void reset(const std::size_t n) {
+		for (auto* p : { &peak, &weight, &r, &g, &b }) {
+			p->assign(n, 0.f);
+		}
+	}
+};
+
+/*
+	The 2D kernel is a product of two 1D gaussians,
+	so instead of drawing the whole radius around every light pixel,
+	the glow is first spread along the rows and then along the columns.
+
+	The strongest contribution is separable as well since the kernel is never negative:
+	the max over all light pixels of kx * ky is the max over rows of ky * (the max over that row of kx).
+
+	The inner loops go over contiguous rows of floats so that the compiler vectorizes them.
+*/
 
 void make_neon(
 	const neon_map_input& input,
@@ -125,64 +158,147 @@ void make_neon(
 
 	resize_image(source, radius);
 
-	thread_local std::vector<double> kernel_;
+	thread_local std::vector<float> kernel_x_;
+	thread_local std::vector<float> kernel_y_;
 	thread_local std::vector<vec2u> pixel_coordinates_;
 	thread_local std::vector<rgba> pixels_original_;
+	thread_local std::vector<augs::simple_pair<unsigned, unsigned>> lit_spans_;
 
-	auto& kernel = kernel_;
+	auto& kernel_x = kernel_x_;
+	auto& kernel_y = kernel_y_;
 	auto& pixel_coordinates = pixel_coordinates_;
-	auto& pixels_original = pixels_original_; 
+	auto& pixels_original = pixels_original_;
+	auto& lit_spans = lit_spans_;
 
 	pixel_coordinates.clear();
 	pixels_original.clear();
 
 	scan_and_hide_undesired_pixels(source, input.light_colors, pixel_coordinates);
-	generate_gauss_kernel(input, kernel);
+	generate_gauss_kernel(input.standard_deviation, radius.x, kernel_x);
+	generate_gauss_kernel(input.standard_deviation, radius.y, kernel_y);
 
 	for (const auto& p : pixel_coordinates) {
 		pixels_original.emplace_back(source.pixel(p));
 	}
 
-	const auto radius_rows = radius.y;
-	const auto radius_cols = radius.x;
 	const auto source_rows = source.get_rows();
 	const auto source_cols = source.get_columns();
+	const auto total_pixels = std::size_t(source_rows) * source_cols;
+
+	auto clamped_range = [](const unsigned center, const unsigned kernel_size, const unsigned limit) {
+		const auto first = static_cast<int>(center) - static_cast<int>(kernel_size / 2);
+
+		return augs::simple_pair<int, int> {
+			std::max(first, 0),
+			std::min(first + static_cast<int>(kernel_size), static_cast<int>(limit))
+		};
+	};
+
+	/* The planes are as large as the whole image, so they are not kept around on the workers. */
+
+	neon_glow_planes rows;
+	neon_glow_planes glow;
+
+	rows.reset(total_pixels);
+	glow.reset(total_pixels);
+
+	lit_spans.assign(source_rows, { source_cols, 0u });
+
+	/* Spread every light pixel along its row. */
 
 	for (std::size_t i = 0; i < pixel_coordinates.size(); ++i) {
 		const auto coord = pixel_coordinates[i];
-		const auto current_light_pixel = pixels_original[i];
+		const auto c = pixels_original[i];
 
-		for (unsigned y = 0; y < radius_rows; ++y) {
-			for (unsigned x = 0; x < radius_cols; ++x) {
-				const unsigned current_index_y = coord.y + y - radius.y / 2;
+		const auto cr = static_cast<float>(c.r);
+		const auto cg = static_cast<float>(c.g);
+		const auto cb = static_cast<float>(c.b);
 
-				if (current_index_y >= source_rows) {
-					continue;
-				}
+		const auto range = clamped_range(coord.x, radius.x, source_cols);
+		const auto kernel_offset = static_cast<int>(coord.x) - static_cast<int>(radius.x / 2);
 
-				const unsigned current_index_x = coord.x + x - radius.x / 2;
+		const auto row = std::size_t(coord.y) * source_cols;
 
-				if (current_index_x >= source_cols) {
-					continue;
-				}
+		float* const peak = rows.peak.data() + row;
+		float* const weight = rows.weight.data() + row;
+		float* const r = rows.r.data() + row;
+		float* const g = rows.g.data() + row;
+		float* const b = rows.b.data() + row;
 
-				if (const auto alpha = std::min(255u, static_cast<unsigned>(255 * kernel[y * radius_cols + x] * input.amplification))) {
-					auto& drawn_pixel = source.pixel({ current_index_x, current_index_y });
+		for (int x = range.first; x < range.second; ++x) {
+			const auto k = kernel_x[x - kernel_offset];
 
-					if (drawn_pixel == PIXEL_NONE) {
-						drawn_pixel[2] = current_light_pixel[2];
-						drawn_pixel[1] = current_light_pixel[1];
-						drawn_pixel[0] = current_light_pixel[0];
-					}
+			peak[x] = std::max(peak[x], k);
+			weight[x] += k;
+			r[x] += k * cr;
+			g[x] += k * cg;
+			b[x] += k * cb;
+		}
 
-					else if (drawn_pixel != current_light_pixel) {
-						drawn_pixel[2] = static_cast<rgba_channel>((alpha * current_light_pixel[2] + drawn_pixel[3] * drawn_pixel[2]) / (alpha + drawn_pixel[3]));
-						drawn_pixel[1] = static_cast<rgba_channel>((alpha * current_light_pixel[1] + drawn_pixel[3] * drawn_pixel[1]) / (alpha + drawn_pixel[3]));
-						drawn_pixel[0] = static_cast<rgba_channel>((alpha * current_light_pixel[0] + drawn_pixel[3] * drawn_pixel[0]) / (alpha + drawn_pixel[3]));
-					}
+		auto& span = lit_spans[coord.y];
+		span.first = std::min(span.first, static_cast<unsigned>(range.first));
+		span.second = std::max(span.second, static_cast<unsigned>(range.second));
+	}
 
-					drawn_pixel[3] = std::max(drawn_pixel[3], static_cast<rgba_channel>(alpha));
-				}
+	/* Spread every lit row along the columns. */
+
+	for (unsigned y = 0; y < source_rows; ++y) {
+		const auto span = lit_spans[y];
+
+		if (span.first >= span.second) {
+			continue;
+		}
+
+		const auto range = clamped_range(y, radius.y, source_rows);
+		const auto kernel_offset = static_cast<int>(y) - static_cast<int>(radius.y / 2);
+
+		const auto src_row = std::size_t(y) * source_cols;
+
+		const float* const src_peak = rows.peak.data() + src_row;
+		const float* const src_weight = rows.weight.data() + src_row;
+		const float* const src_r = rows.r.data() + src_row;
+		const float* const src_g = rows.g.data() + src_row;
+		const float* const src_b = rows.b.data() + src_row;
+
+		for (int ty = range.first; ty < range.second; ++ty) {
+			const auto k = kernel_y[ty - kernel_offset];
+			const auto dst_row = std::size_t(ty) * source_cols;
+
+			float* const peak = glow.peak.data() + dst_row;
+			float* const weight = glow.weight.data() + dst_row;
+			float* const r = glow.r.data() + dst_row;
+			float* const g = glow.g.data() + dst_row;
+			float* const b = glow.b.data() + dst_row;
+
+			for (unsigned x = span.first; x < span.second; ++x) {
+				peak[x] = std::max(peak[x], k * src_peak[x]);
+				weight[x] += k * src_weight[x];
+				r[x] += k * src_r[x];
+				g[x] += k * src_g[x];
+				b[x] += k * src_b[x];
+			}
+		}
+	}
+
+	{
+		const auto alpha_scale = 255.0 * input.amplification;
+
+		auto p = source.begin();
+
+		for (std::size_t i = 0; i < total_pixels; ++i, ++p) {
+			if (const auto alpha = std::min(255u, static_cast<unsigned>(alpha_scale * glow.peak[i]))) {
+				const auto inv_weight = 1.f / glow.weight[i];
+
+				auto to_channel = [inv_weight](const float sum) {
+					return static_cast<rgba_channel>(std::min(255.f, sum * inv_weight + 0.5f));
+				};
+
+				*p = rgba(
+					to_channel(glow.r[i]),
+					to_channel(glow.g[i]),
+					to_channel(glow.b[i]),
+					static_cast<rgba_channel>(alpha)
+				);
 			}
 		}
 	}
@@ -198,48 +314,37 @@ void make_neon(
 	}
 }
 
-void generate_gauss_kernel(const neon_map_input& input, std::vector<double>& result) {
-	const auto radius = input.radius;
-	const auto rows = radius.y;
-	const auto cols = radius.x;
-	const auto total_pixels = rows * cols;
+void generate_gauss_kernel(
+	const float standard_deviation,
+	const unsigned size,
+	std::vector<float>& result
+) {
+	result.resize(size);
 
-	thread_local std::vector<augs::simple_pair<int, int>> index_;
-	auto& index = index_;
+	const auto max_index = static_cast<int>(size / 2);
+	const auto variance = std::pow(static_cast<double>(standard_deviation), 2);
 
-	index.resize(total_pixels);
-	result.resize(total_pixels);
+	/* Normalizing both 1D kernels normalizes their product. */
 
-	{
-		const auto max_index_x = radius.x / 2;
-		const auto max_index_y = radius.y / 2;
-
-		for (unsigned y = 0; y < radius.y; ++y) {
-			for (unsigned x = 0; x < radius.x; ++x) {
-				index[y * cols + x] = { 
-					static_cast<int>(x - max_index_x),
-				   	static_cast<int>(y - max_index_y)
-				};
-			}
-		}
-	}
+	thread_local std::vector<double> values_;
+	auto& values = values_;
 
-	for (unsigned i = 0; i < total_pixels; ++i) {
-		result[i] = std::exp(-1 * (std::pow(index[i].first, 2) + std::pow(index[i].second, 2)) / 2 / std::pow(input.standard_deviation, 2)) / PI<float> / 2 / std::pow(input.standard_deviation, 2);
-	}
+	values.resize(size);
+
+	double sum = 0.0;
 
-	double sum = 0.f;
+	for (unsigned i = 0; i < size; ++i) {
+		const auto offset = static_cast<int>(i) - max_index;
 
-	for (const auto& v : result) {
-		sum += v;
+		values[i] = std::exp(-1 * std::pow(offset, 2) / 2 / variance);
+		sum += values[i];
 	}
 
-	for (auto& v : result) {
-		v /= sum;
+	for (unsigned i = 0; i < size; ++i) {
+		result[i] = static_cast<float>(values[i] / sum);
 	}
 }
 
-
 void scan_and_hide_undesired_pixels(
 	augs::image& original_image,
 	const std::vector<rgba>& color_whitelist,
@@ -346,3 +451,90 @@ void cut_empty_edges(augs::image& source) {
 
 	source = std::move(copy);
 }
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("NeonMaps SeparableGlow") {
+	neon_map_input in;
+	in.standard_deviation = 3.f;
+	in.radius = { 21u, 15u };
+	in.amplification = 60.f;
+
+	const auto light = rgba(255, 0, 0, 255);
+	const auto other = rgba(0, 255, 0, 255);
+
+	in.light_colors = { light };
+
+	augs::image source;
+	source.resize_fill({ 6u, 5u });
+	source.pixel({ 1u, 1u }) = light;
+	source.pixel({ 4u, 3u }) = light;
+	source.pixel({ 2u, 4u }) = other;
+
+	/* The way make_neon used to draw the whole 2D kernel around every light pixel. */
+
+	auto expected = source;
+
+	{
+		resize_image(expected, in.radius);
+
+		std::vector<vec2u> lights;
+		scan_and_hide_undesired_pixels(expected, in.light_colors, lights);
+
+		const auto half = vec2i(in.radius / 2);
+		const auto variance = std::pow(static_cast<double>(in.standard_deviation), 2);
+
+		double sum = 0.0;
+
+		for (int y = 0; y < int(in.radius.y); ++y) {
+			for (int x = 0; x < int(in.radius.x); ++x) {
+				sum += std::exp(-(std::pow(x - half.x, 2) + std::pow(y - half.y, 2)) / 2 / variance);
+			}
+		}
+
+		for (unsigned y = 0; y < expected.get_rows(); ++y) {
+			for (unsigned x = 0; x < expected.get_columns(); ++x) {
+				double peak = 0.0;
+
+				for (const auto& l : lights) {
+					const auto dx = int(x) - int(l.x);
+					const auto dy = int(y) - int(l.y);
+
+					if (dx >= -half.x && dx < int(in.radius.x) - half.x && dy >= -half.y && dy < int(in.radius.y) - half.y) {
+						peak = std::max(peak, std::exp(-(std::pow(dx, 2) + std::pow(dy, 2)) / 2 / variance) / sum);
+					}
+				}
+
+				if (const auto alpha = std::min(255u, static_cast<unsigned>(255 * peak * in.amplification))) {
+					expected.pixel({ x, y }) = rgba(light.r, light.g, light.b, static_cast<rgba_channel>(alpha));
+				}
+			}
+		}
+
+		for (const auto& l : lights) {
+			expected.pixel(l) = light;
+		}
+
+		cut_empty_edges(expected);
+	}
+
+	make_neon(in, source);
+
+	REQUIRE(source.get_size() == expected.get_size());
+
+	for (unsigned y = 0; y < source.get_rows(); ++y) {
+		for (unsigned x = 0; x < source.get_columns(); ++x) {
+			const auto a = source.pixel({ x, y });
+			const auto b = expected.pixel({ x, y });
+
+			REQUIRE(a.r == b.r);
+			REQUIRE(a.g == b.g);
+			REQUIRE(a.b == b.b);
+
+			/* Float rounding might tip the truncation either way. */
+			REQUIRE(std::abs(int(a.a) - int(b.a)) <= 1);
+		}
+	}
+}
+#endif
@@ -2,11 +2,11 @@
 #include <compare>
 #include <vector>
 #include <cstddef>
-#include <chrono>
+#include <optional>
 
 #include "augs/graphics/rgba.h"
 #include "augs/filesystem/path.h"
-#include "augs/filesystem/file_time_type.h"
+#include "augs/misc/secure_hash.h"
 
 struct neon_map_input {
 	// GEN INTROSPECTOR struct neon_map_input
@@ -28,7 +28,7 @@ struct neon_map_input {
 struct neon_map_stamp {
 	// GEN INTROSPECTOR struct neon_map_stamp
 	neon_map_input input;
-	augs::file_time_type last_write_time_of_source;
+	augs::secure_hash_type source_hash;
 	// END GEN INTROSPECTOR
 };
 
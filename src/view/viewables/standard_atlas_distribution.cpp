@@ -14,6 +14,7 @@
 #include "augs/readwrite/byte_file.h"
 #include "augs/readwrite/to_bytes.h"
 #include "augs/filesystem/directory.h"
+#include "augs/texture_atlas/cached_atlas.h"
 
 augs::path_type get_path_in_cache(const augs::path_type& from_source_path);
 
@@ -119,19 +120,29 @@ void regenerate_and_gather_subjects(
 		int total_to_regenerate = 0;
 
 		std::vector<std::optional<cached_neon_map_in>> neon_regen_inputs;
+		neon_regen_inputs.resize(in.image_definitions.get_objects().size());
 
-		for (const auto& d : in.image_definitions) {
-			const bool force = in.settings.regenerate_every_time;
+		{
+			/* Stamps hash the source files, so they are checked in parallel too. */
 
-			const auto def = make_view(d);
+			for (const auto& d : in.image_definitions) {
+				workers.enqueue([&d, &in, make_view, &neon_regen_inputs]() {
+					const auto this_i = index_in(in.image_definitions.get_objects(), d);
+					const bool force = in.settings.regenerate_every_time;
+
+					neon_regen_inputs[this_i] = make_view(d).should_regenerate_neon_map(force);
+				});
+			}
 
-			auto result = def.should_regenerate_neon_map(force);
+			workers.submit();
+			workers.help_until_no_tasks();
+			workers.wait_for_all_tasks_to_complete();
+		}
 
+		for (const auto& result : neon_regen_inputs) {
 			if (result.has_value()) {
 				++total_to_regenerate;
 			}
-
-			neon_regen_inputs.emplace_back(std::move(result));
 		}
 
 		if (in.progress) {
@@ -213,19 +224,29 @@ general_atlas_output create_general_atlas(
 	thread_local baked_atlas baked;
 	baked.clear();
 
-	bake_fresh_atlas(
-		{
-			atlas_subjects,
-			in.max_atlas_size,
-			in.subjects.settings.atlas_blitting_threads
-		},
-		{
-			in.atlas_image_output,
-			in.fallback_output,
-			baked,
-			performance
-		}
-	);
+	const auto& settings = in.subjects.settings;
+
+	const auto bake_in = bake_fresh_atlas_input {
+		atlas_subjects,
+		in.max_atlas_size,
+		settings.atlas_blitting_threads
+	};
+
+	const auto bake_out = bake_fresh_atlas_output {
+		in.atlas_image_output,
+		in.fallback_output,
+		baked,
+		performance
+	};
+
+	if (settings.cache_atlases && !settings.regenerate_every_time) {
+		const auto cache_dir = CACHE_DIR / "atlases";
+
+		bake_cached_atlas(bake_in, bake_out, { cache_dir, settings.max_cached_atlases });
+	}
+	else {
+		bake_fresh_atlas(bake_in, bake_out);
+	}
 
 	auto scope = measure_scope(performance.unpacking_results);
 
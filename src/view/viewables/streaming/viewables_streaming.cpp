@@ -14,6 +14,7 @@
 #include "augs/filesystem/file.h"
 #include "augs/filesystem/directory.h"
 #include "augs/misc/compress.h"
+#include "augs/misc/readable_bytesize.h"
 #include "augs/readwrite/byte_file.h"
 #include "augs/readwrite/to_bytes.h"
 #include "application/setups/client/demo_file_meta.h"
@@ -260,7 +261,11 @@ void viewables_streaming::load_all(const viewables_load_input in) {
 			const auto def_view = sound_definition_view(unofficial_content_dir, def);
 			const auto input = def_view.make_sound_loading_input();
 
-			return input;
+			return augs::sound_buffer_loading_input {
+				input.source_sound,
+				input.settings,
+				settings.stream_sounds_longer_than_secs
+			};
 		};
 
 		auto& now_defs = now_all_defs.sounds;
@@ -381,6 +386,18 @@ void viewables_streaming::finalize_load(viewables_finalize_input in) {
 		auto& now_loaded_defs = now_all_defs.sounds;
 		auto& new_loaded_defs = future_sound_definitions;
 
+		auto calc_resident_sound_bytes = [&]() {
+			std::size_t total = 0;
+
+			for (const auto& it : loaded_sounds) {
+				total += it.second.get_resident_bytes();
+			}
+
+			return total;
+		};
+
+		const auto resident_bytes_before = calc_resident_sound_bytes();
+
 		{
 			thread_local std::unordered_set<ALuint> all_unloaded_buffers;
 
@@ -427,6 +444,21 @@ void viewables_streaming::finalize_load(viewables_finalize_input in) {
 			}
 		}
 
+		std::size_t num_streamed = 0;
+
+		for (const auto& it : loaded_sounds) {
+			for (const auto& v : it.second.get_variations()) {
+				num_streamed += v.is_streamed() ? 1 : 0;
+			}
+		}
+
+		LOG(
+			"Resident sound memory: %x before loading, %x after. %x sounds are streamed.",
+			readable_bytesize(resident_bytes_before),
+			readable_bytesize(calc_resident_sound_bytes()),
+			num_streamed
+		);
+
 		/* Done, overwrite */
 		now_loaded_defs = new_loaded_defs;
 		sound_requests.clear();
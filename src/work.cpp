@@ -87,6 +87,7 @@
 #include "application/gui/ingame_menu_gui.h"
 
 #include "application/masterserver/masterserver.h"
+#include "application/load_test/load_test.h"
 
 #include "application/network/network_common.h"
 #include "application/setups/all_setups.h"
@@ -642,6 +643,24 @@ work_result work(
 		return work_result::SUCCESS;
 	}
 
+	if (params.type == app_type::LOAD_TEST) {
+#if BUILD_NETWORKING
+		auto settings = config.load_test;
+
+		if (params.should_connect) {
+			settings.connect_address = params.connect_address;
+		}
+
+		const auto official = std::make_unique<packaged_official_content>(lua);
+
+		perform_load_test(lua, *official, settings);
+#else
+		LOG("The load test requires networking, but this build has none.");
+#endif
+
+		return work_result::SUCCESS;
+	}
+
 	auto chosen_server_port = [&](){
 		if (params.server_port.has_value()) {
 			return *params.server_port;
@@ -928,6 +947,152 @@ work_result work(
 
 		auto& server = *server_ptr;
 
+		/*
+			Additional arenas are hosted by the same process, each at the next port after the main one.
+			They share the Lua state and the official content with the main server,
+			and are stepped on this thread since neither of these is safe to use concurrently.
+
+			This makes the cost of a tick the sum of the step times of all arenas,
+			so a heavy step of one arena delays the ticks of all others.
+			Each arena logs its own step times, so watch their sum against the tick interval
+			before adding more arenas to a single process.
+
+			Arena data is not shared between the arenas beyond the official content:
+			every cosmos owns its common state (flavours, assets) by value,
+			so even two arenas of the same map keep separate copies.
+		*/
+
+		struct additional_arena {
+			std::unique_ptr<server_setup> setup;
+			network_profiler network_performance;
+			server_network_info server_stats;
+			nat_detection_result detected_nat;
+		};
+
+		std::vector<additional_arena> additional_arenas;
+
+		const auto& additional_arena_names = config.dedicated_server.additional_arenas;
+
+		auto get_additional_port = [&](const std::size_t i) {
+			return static_cast<port_type>(bound_port + 1 + i);
+		};
+
+		auto additional_detected_nats = std::vector<nat_detection_result>(additional_arena_names.size());
+
+		if (config.server.allow_nat_traversal && additional_arena_names.size() > 0) {
+			/* 
+				The NAT might translate every port differently,
+				so every additional port gets its own detection, all running at once.
+			*/
+
+			struct port_nat_detection {
+				std::size_t arena_index;
+				netcode_socket_raii socket;
+				nat_detection_session session;
+
+				port_nat_detection(
+					const std::size_t arena_index,
+					const port_type port,
+					const nat_detection_settings& settings,
+					stun_server_provider& stun_provider
+				) : 
+					arena_index(arena_index),
+					socket(port),
+					session(settings, stun_provider)
+				{}
+
+				bool complete() const {
+					return session.query_result().has_value();
+				}
+			};
+
+			std::vector<std::unique_ptr<port_nat_detection>> detections;
+
+			for (std::size_t i = 0; i < additional_arena_names.size(); ++i) {
+				try {
+					detections.emplace_back(std::make_unique<port_nat_detection>(i, get_additional_port(i), config.nat_detection, stun_provider));
+				}
+				catch (const netcode_socket_raii_error&) {
+					LOG("WARNING! Could not bind the nat detection socket to the additional arena port: %x.", get_additional_port(i));
+				}
+			}
+
+			LOG("Waiting for NAT detection of %x additional arena ports to complete...", detections.size());
+
+			auto all_complete = [&]() {
+				return std::all_of(detections.begin(), detections.end(), [](const auto& d) { return d->complete(); });
+			};
+
+			while (!all_complete()) {
+				for (auto& d : detections) {
+					if (!d->complete()) {
+						d->session.advance(d->socket.socket);
+					}
+				}
+
+				if (handle_sigint()) {
+					return work_result::SUCCESS;
+				}
+
+				yojimbo_sleep(1.0 / 1000);
+			}
+
+			for (const auto& d : detections) {
+				additional_detected_nats[d->arena_index] = *d->session.query_result();
+			}
+		}
+
+		for (std::size_t i = 0; i < additional_arena_names.size(); ++i) {
+			const auto& arena_name = additional_arena_names[i];
+
+			auto additional_start = start;
+			additional_start.port = get_additional_port(i);
+
+			auto additional_vars = config.server;
+			additional_vars.arena = arena_name;
+
+			{
+				/* Tell the arenas apart in the server list. */
+				const auto suffix = typesafe_sprintf(" #%x", i + 2);
+				auto name = std::string(config.server.server_name);
+
+				name.resize(std::min(name.size(), max_server_name_length_v - suffix.size()));
+				additional_vars.server_name = name + suffix;
+			}
+
+			auto additional_private_vars = config.server_private;
+
+			if (auto& metrics_path = additional_private_vars.performance_metrics_path; !metrics_path.empty()) {
+				/* So that the arenas do not overwrite each other's metrics. */
+				auto path = augs::path_type(metrics_path);
+				const auto extension = path.extension();
+
+				path.replace_extension();
+				path += typesafe_sprintf("_%x", additional_start.port);
+				path += extension;
+
+				metrics_path = path.string();
+			}
+
+			LOG("Hosting an additional arena: %x at port: %x", arena_name, additional_start.port);
+
+			auto& added = additional_arenas.emplace_back();
+			added.detected_nat = additional_detected_nats[i];
+
+			added.setup = std::make_unique<server_setup>(
+				lua,
+				*official,
+				additional_start,
+				additional_vars,
+				additional_private_vars,
+				config.client,
+				config.dedicated_server,
+
+				make_server_nat_traversal_input(),
+				params.suppress_server_webhook
+			);
+		}
+
 		std::future<self_update_result> availability_check;
 
 		auto write_vars_to_disk = [&]() {
@@ -936,6 +1101,21 @@ work_result work(
 			});
 		};
 
+		/*
+			The additional arenas were started with the main server's vars,
+			so only their arena is their own.
+		*/
+
+		auto write_additional_vars_to_disk = [&](const std::size_t i) {
+			const auto& vars = additional_arenas[i].setup->get_current_vars();
+
+			change_with_save([&](auto& cfg) {
+				if (i < cfg.dedicated_server.additional_arenas.size()) {
+					cfg.dedicated_server.additional_arenas[i] = vars.arena;
+				}
+			});
+		};
+
 		auto save_config = augs::scope_guard([&]() {
 			write_vars_to_disk();
 		});
@@ -947,23 +1127,54 @@ work_result work(
 				return work_result::SUCCESS;
 			}
 
-			server.advance(
-				{
-					vec2i(),
-					config.input,
-					zoom,
-					get_detected_nat(),
-					network_performance,
-					server_stats
-				},
-				solver_callbacks()
-			);
+			auto advance_server = [&](server_setup& advanced, const nat_detection_result& detected_nat, network_profiler& performance, server_network_info& stats) {
+				advanced.advance(
+					{
+						vec2i(),
+						config.input,
+						zoom,
+						detected_nat,
+						performance,
+						stats
+					},
+					solver_callbacks()
+				);
+			};
+
+			advance_server(server, get_detected_nat(), network_performance, server_stats);
+
+			bool check_for_updates = server.should_check_for_updates_once();
 
 			if (server.should_write_vars_to_disk_once()) {
 				write_vars_to_disk();
 			}
 
-			if (server.should_check_for_updates_once()) {
+			for (std::size_t i = 0; i < additional_arenas.size(); ++i) {
+				auto& additional = additional_arenas[i];
+				auto& additional_server = *additional.setup;
+
+				if (!additional_server.is_running()) {
+					continue;
+				}
+
+				advance_server(additional_server, additional.detected_nat, additional.network_performance, additional.server_stats);
+
+				if (additional_server.should_write_vars_to_disk_once()) {
+					write_additional_vars_to_disk(i);
+				}
+
+				if (additional_server.should_check_for_updates_once()) {
+					check_for_updates = true;
+				}
+
+				if (!additional_server.is_running() && additional_server.server_restart_requested()) {
+					/* The arenas share the process, so they can only restart together. */
+					LOG("An additional arena requested a restart. Restarting the whole server.");
+					server.schedule_restart();
+				}
+			}
+
+			if (check_for_updates && !availability_check.valid()) {
 				LOG("Launching an async check for updates.");
 
 				auto config_http_client = config.http_client;
@@ -1004,7 +1215,19 @@ work_result work(
 				}
 			}
 
-			server.sleep_until_next_tick();
+			{
+				auto soonest_ticking = std::addressof(server);
+
+				for (auto& additional : additional_arenas) {
+					const auto& candidate = *additional.setup;
+
+					if (candidate.is_running() && candidate.get_secs_until_next_tick() < soonest_ticking->get_secs_until_next_tick()) {
+						soonest_ticking = additional.setup.get();
+					}
+				}
+
+				soonest_ticking->sleep_until_next_tick();
+			}
 		}
 #endif
 
@@ -1024,7 +1247,7 @@ work_result work(
 
 	auto thread_pool = augs::thread_pool(config.performance.get_num_pool_workers());
 
-	augs::audio_command_buffers audio_buffers(thread_pool);
+	augs::audio_command_buffers audio_buffers;
 
 	LOG("Initializing the window.");
 	augs::window window(config.window);